@@ -1,45 +1,75 @@
+#include "prelude/aoc.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
+#include "prelude/simd.hpp"
 
-int part1(const std::string &line) {
-    return line | rv::transform([](const char ch) {
-               switch (ch) {
-               case '(':
-                   return 1;
-               case ')':
-                   return -1;
-               default:
-                   return 0;
-               }
-           })
-           | prelude::sum;
-}
+namespace {
+
+namespace simd = prelude::simd;
 
-int part2(const std::string &line) {
-    int state = 0;
-    for (auto [idx, ch] : rv::enumerate(line)) {
-        switch (ch) {
-        case '(':
-            ++state;
-            break;
-        case ')':
-            --state;
-            break;
-        default:
-            break;
-        }
-        if (-1 == state) {
-            return 1 + idx;
-        }
+int step(const char ch) {
+    switch (ch) {
+    case '(':
+        return 1;
+    case ')':
+        return -1;
+    default:
+        return 0;
     }
-    spdlog::error("We never reach the basement. Wat.");
-    return -1;
 }
 
-int main(int, char **) {
-    auto input = prelude::front(prelude::line_view(std::cin));
-    auto p1 = part1(input);
-    fmt::print("part 1: {}\n", p1);
-    auto p2 = part2(input);
-    fmt::print("part 2: {}\n", p2);
-    return 0;
-}
\ No newline at end of file
+int part1(std::string_view line) {
+    return simd::dispatch(
+        []<size_t W>(std::string_view s) {
+            size_t i = 0;
+            long floor = 0;
+            if constexpr (W > 0) {
+                using V = simd::vec<char, W>;
+                for (; i + W <= s.size(); i += W) {
+                    const V v = V::load(s.data() + i);
+                    floor += simd::count(v == '(') - simd::count(v == ')');
+                }
+            }
+            for (; i < s.size(); ++i) {
+                floor += step(s[i]);
+            }
+            return static_cast<int>(floor);
+        },
+        line);
+}
+
+int part2(std::string_view line) {
+    return simd::dispatch(
+        []<size_t W>(std::string_view s) {
+            size_t i = 0;
+            long state = 0;
+            if constexpr (W > 0) {
+                // skip whole blocks that can't take us below floor 0: even if
+                // every ')' came first we'd still be at or above it
+                using V = simd::vec<char, W>;
+                for (; i + W <= s.size(); i += W) {
+                    const V v = V::load(s.data() + i);
+                    const long down = simd::count(v == ')');
+                    if (state - down < 0) {
+                        break;
+                    }
+                    state += simd::count(v == '(') - down;
+                }
+            }
+            for (; i < s.size(); ++i) {
+                state += step(s[i]);
+                if (-1 == state) {
+                    return static_cast<int>(1 + i);
+                }
+            }
+            spdlog::error("We never reach the basement. Wat.");
+            return -1;
+        },
+        line);
+}
+
+std::string_view parse(std::string_view input) { return prelude::front(prelude::lines(input)); }
+
+} // namespace
+
+AOC_SOLUTION(2015, 1, parse, part1, part2);
@@ -0,0 +1,17 @@
+#include "prelude/gen.hpp"
+
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 7000l, "number of parentheses");
+    const double up = args.get("up", 0.5, "chance of each one being '('");
+    prelude::rng rng(args.seed());
+    args.done();
+
+    for (long i = 0; i < n; ++i) {
+        out.put(rng.chance(up) ? '(' : ')');
+    }
+    out.put('\n');
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2015 day 1: one line of parentheses.", generate);
+}
@@ -1,31 +1,52 @@
+#include "prelude/aoc.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
+#include "prelude/soa.hpp"
 
-using std::operator""sv;
+namespace {
 
-struct Package {
-    int height, length, width;
+// Height, length and width of each package, sorted so height <= length <= width.
+using Packages = prelude::soa_vector<int, int, int>;
 
-    int wrappingRequired() const {
-        return 3 * height * length + 2 * height * width + 2 * length * width;
-    }
-    int ribbonRequired() const { return 2 * (height + length) + height * length * width; }
-};
+int wrappingRequired(int height, int length, int width) {
+    return 3 * height * length + 2 * height * width + 2 * length * width;
+}
+int ribbonRequired(int height, int length, int width) {
+    return 2 * (height + length) + height * length * width;
+}
 
-Package fromString(const std::string &s) {
-    std::vector<int> dims = rv::split(s, "x"sv) | rv::transform([](const auto &r) {
-                                return std::stoi(std::string(std::begin(r), std::end(r)));
-                            })
-                            | prelude::collect<std::vector>;
+constexpr std::array<int, 3> fromString(std::string_view s) {
+    auto dims = prelude::ints<3, int>(s);
     // guaranteeing that height <= length <= width
     std::sort(dims.begin(), dims.end());
-    return Package{dims[0], dims[1], dims[2]};
+    return dims;
+}
+
+Packages parse(std::string_view input) {
+    return Packages(prelude::lines(input) | rv::transform(fromString));
+}
+
+int part1(const Packages &packages) {
+    return packages | rv::transform([](auto p) { return std::apply(wrappingRequired, p); })
+           | prelude::sum;
 }
 
-int main(int, char **) {
-    std::vector<Package> packages
-        = prelude::line_view(std::cin) | rv::transform(fromString) | prelude::collect<std::vector>;
-    int part1 = packages | rv::transform(&Package::wrappingRequired) | prelude::sum;
-    int part2 = packages | rv::transform(&Package::ribbonRequired) | prelude::sum;
-    fmt::print("part 1: {}\n", part1);
-    fmt::print("part 2: {}\n", part2);
-}
\ No newline at end of file
+int part2(const Packages &packages) {
+    return packages | rv::transform([](auto p) { return std::apply(ribbonRequired, p); })
+           | prelude::sum;
+}
+
+#ifdef AOC_EMBEDDED_INPUT
+// The whole parse, done by the compiler.
+constexpr auto embedded_packages
+    = prelude::map_lines<prelude::embedded_lines>(prelude::embedded_input, fromString);
+
+Packages embedded() { return Packages(embedded_packages); }
+#endif
+
+} // namespace
+
+AOC_SOLUTION(2015, 2, parse, part1, part2);
+#ifdef AOC_EMBEDDED_INPUT
+AOC_SOLUTION_EMBEDDED(2015, 2, embedded);
+#endif
@@ -0,0 +1,17 @@
+#include "prelude/gen.hpp"
+
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 1000l, "number of presents");
+    const long max = args.get("max", 30l, "sides are in [1, max]");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(max >= 1, "max must be at least 1");
+
+    for (long i = 0; i < n; ++i) {
+        out.print("{}x{}x{}\n", rng.uniform(1l, max), rng.uniform(1l, max), rng.uniform(1l, max));
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2015 day 2: n presents, LxWxH.", generate);
+}
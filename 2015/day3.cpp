@@ -1,5 +1,9 @@
+#include "prelude/aoc.hpp"
+#include "prelude/hash.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
-#include <set>
+
+namespace {
 
 struct coord {
     int x, y;
@@ -11,7 +15,8 @@ const std::map<char, coord> directions
     = {{'>', {1, 0}}, {'<', {-1, 0}}, {'^', {0, 1}}, {'v', {0, -1}}};
 
 int countHouses(const std::vector<coord> &moves) {
-    std::set<coord> houses;
+    prelude::flat_set<coord> houses;
+    houses.reserve(moves.size() + 1);
     coord position{0, 0};
     houses.insert(position);
     for (const auto &move : moves) {
@@ -22,7 +27,8 @@ int countHouses(const std::vector<coord> &moves) {
 }
 
 int roboHouses(const std::vector<coord> &moves) {
-    std::set<coord> seen;
+    prelude::flat_set<coord> seen;
+    seen.reserve(moves.size() + 1);
     coord s{0, 0}, r{0, 0};
     seen.insert(s);
     for (auto [idx, m] : rv::enumerate(moves)) {
@@ -37,20 +43,17 @@ int roboHouses(const std::vector<coord> &moves) {
     return seen.size();
 }
 
-int main(int, char **) {
-    std::vector<coord> moves
-        = prelude::front(prelude::line_view(std::cin)) | rv::transform([](const char ch) {
-              auto it = directions.find(ch);
-              if (it != directions.end()) {
-                  return it->second;
-              }
-              throw std::logic_error(fmt::format("No such direction {}", ch));
-          })
-          | prelude::collect<std::vector>;
-
-    int part1 = countHouses(moves);
-    fmt::print("part 1: {}\n", part1);
-    int part2 = roboHouses(moves);
-    fmt::print("part 2: {}\n", part2);
-    return 0;
-}
\ No newline at end of file
+std::vector<coord> parse(std::string_view input) {
+    return prelude::front(prelude::lines(input)) | rv::transform([](const char ch) {
+               auto it = directions.find(ch);
+               if (it != directions.end()) {
+                   return it->second;
+               }
+               throw std::logic_error(fmt::format("No such direction {}", ch));
+           })
+           | prelude::collect<std::vector>;
+}
+
+} // namespace
+
+AOC_SOLUTION(2015, 3, parse, countHouses, roboHouses);
\ No newline at end of file
@@ -0,0 +1,17 @@
+#include "prelude/gen.hpp"
+
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 8192l, "number of moves");
+    prelude::rng rng(args.seed());
+    args.done();
+
+    constexpr std::string_view moves = "^v<>";
+    for (long i = 0; i < n; ++i) {
+        out.put(rng.pick(moves));
+    }
+    out.put('\n');
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2015 day 3: one line of n moves.", generate);
+}
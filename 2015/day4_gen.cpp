@@ -0,0 +1,19 @@
+#include "prelude/gen.hpp"
+
+// The work here is set by the puzzle (five, then six leading zeros), not by
+// the key, so there's no size to turn up: different keys just land the
+// answers at different nonces, which is what you want for averaging.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long len = args.get("len", 8l, "key length");
+    prelude::rng rng(args.seed());
+    args.done();
+
+    for (long i = 0; i < len; ++i) {
+        out.put(static_cast<char>('a' + rng.uniform(0, 25)));
+    }
+    out.put('\n');
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2015 day 4: a secret key.", generate);
+}
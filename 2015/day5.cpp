@@ -1,5 +1,10 @@
+#include "prelude/aoc.hpp"
+#include "prelude/input.hpp"
+#include "prelude/parallel.hpp"
 #include "prelude/prelude.hpp"
 
+namespace {
+
 const std::string_view vowels = "aeiou"sv;
 const std::array<std::string_view, 4> disallowed = {"ab"sv, "cd"sv, "pq"sv, "xy"sv};
 
@@ -44,18 +49,20 @@ bool doubleRepeater(std::string_view s) {
 
 bool isNice2(std::string_view s) { return repeatSpaced(s) && doubleRepeater(s); }
 
-int main(int, char **) {
-    int part1 = 0;
-    int part2 = 0;
-    prelude::line_view(std::cin) | prelude::for_each([&](std::string_view s) {
-        if (isNice1(s)) {
-            ++part1;
-        }
-        if (isNice2(s)) {
-            ++part2;
-        }
-    });
-    fmt::print("part 1: {}\n", part1);
-    fmt::print("part 2: {}\n", part2);
-    return 0;
-}
\ No newline at end of file
+std::vector<std::string_view> parse(std::string_view input) {
+    return prelude::lines(input) | prelude::collect<std::vector>;
+}
+
+int part1(const std::vector<std::string_view> &lines) {
+    return lines | rv::transform([](std::string_view s) { return isNice1(s) ? 1 : 0; })
+           | prelude::par_sum;
+}
+
+int part2(const std::vector<std::string_view> &lines) {
+    return lines | rv::transform([](std::string_view s) { return isNice2(s) ? 1 : 0; })
+           | prelude::par_sum;
+}
+
+} // namespace
+
+AOC_SOLUTION(2015, 5, parse, part1, part2);
\ No newline at end of file
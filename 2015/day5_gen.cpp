@@ -0,0 +1,19 @@
+#include "prelude/gen.hpp"
+
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 1000l, "number of strings");
+    const long len = args.get("len", 16l, "length of each string");
+    prelude::rng rng(args.seed());
+    args.done();
+
+    for (long i = 0; i < n; ++i) {
+        for (long j = 0; j < len; ++j) {
+            out.put(static_cast<char>('a' + rng.uniform(0, 25)));
+        }
+        out.put('\n');
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2015 day 5: n random lowercase strings.", generate);
+}
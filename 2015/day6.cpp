@@ -1,7 +1,12 @@
+#include "prelude/aoc.hpp"
+#include "prelude/grid.hpp"
+#include "prelude/input.hpp"
+#include "prelude/parallel.hpp"
 #include "prelude/prelude.hpp"
-#include <regex>
 #include <variant>
 
+namespace {
+
 const int N = 1000;
 
 struct coord {
@@ -21,84 +26,74 @@ struct Toggle {
 
 using Instruction = std::variant<Turn, Toggle>;
 
-const std::regex turn_re("turn (on|off) (\\d+),(\\d+) through (\\d+),(\\d+)");
-const std::regex toggle_re("toggle (\\d+),(\\d+) through (\\d+),(\\d+)");
-Instruction parseInstruction(std::string_view _s) {
-    std::string s(_s);
-    std::smatch match;
-    if (std::regex_match(s, match, turn_re)) {
-        bool direction = match[1].str() == "on"sv;
-        coord a{std::stoi(match[2].str()), std::stoi(match[3].str())};
-        coord b{std::stoi(match[4].str()), std::stoi(match[5].str())};
-        return Turn{direction,
-                    {std::min(a.x, b.x), std::min(a.y, b.y)},
-                    {std::max(a.x, b.x), std::max(a.y, b.y)}};
-    } else if (std::regex_match(s, match, toggle_re)) {
-        coord a{std::stoi(match[1].str()), std::stoi(match[2].str())};
-        coord b{std::stoi(match[3].str()), std::stoi(match[4].str())};
-        return Toggle{{std::min(a.x, b.x), std::min(a.y, b.y)},
-                      {std::max(a.x, b.x), std::max(a.y, b.y)}};
+Instruction parseInstruction(std::string_view s) {
+    if (auto turn = prelude::scan<"turn {} {},{} through {},{}", std::string_view, int, int, int,
+                                  int>(s);
+        turn && (std::get<0>(*turn) == "on"sv || std::get<0>(*turn) == "off"sv)) {
+        auto [direction, ax, ay, bx, by] = *turn;
+        return Turn{direction == "on"sv,
+                    {std::min(ax, bx), std::min(ay, by)},
+                    {std::max(ax, bx), std::max(ay, by)}};
+    } else if (auto toggle = prelude::scan<"toggle {},{} through {},{}", int, int, int, int>(s)) {
+        auto [ax, ay, bx, by] = *toggle;
+        return Toggle{{std::min(ax, bx), std::min(ay, by)}, {std::max(ax, bx), std::max(ay, by)}};
     } else {
         throw std::runtime_error(fmt::format("malformed input: {}", s));
     }
 }
 
-template <typename T> class Grid {
-  private:
-    std::vector<T> _g;
-    int _rows, _cols;
-
-  public:
-    Grid(const int rows, const int cols) : _g(rows * cols), _rows(rows), _cols(cols) {}
-
-    int rows() const { return _rows; }
-    int cols() const { return _cols; }
-
-    const std::vector<T> &elts() const { return _g; }
-
-    T get(int r, int c) const {
-        assert(r >= 0 && r < _rows);
-        assert(c >= 0 && c < _cols);
-        return _g[r * _cols + c];
-    }
-
-    void set(int r, int c, const T &x) {
-        assert(r >= 0 && r < _rows);
-        assert(c >= 0 && c < _cols);
-        _g[r * _cols + c] = x;
-    }
-};
+std::vector<Instruction> parse(std::string_view input) {
+    return prelude::par_lines(input, parseInstruction);
+}
 
-int main(int, char **) {
-    Grid<bool> g(N, N);
-    Grid<int> g2(N, N);
-    for (auto line : prelude::line_view(std::cin)) {
-        auto inst = parseInstruction(line);
+// Runs every instruction over the grid, with f(cell, instruction) doing the
+// per-light work.
+template <typename T, typename F>
+prelude::Grid<T> apply(const std::vector<Instruction> &instructions, F f) {
+    prelude::Grid<T> g(N, N);
+    for (const auto &inst : instructions) {
         std::visit(
             [&](auto &&arg) {
-                using T = std::decay_t<decltype(arg)>;
                 for (int r = arg.tl.y; r <= arg.br.y; ++r) {
+                    auto row = g.row(r);
                     for (int c = arg.tl.x; c <= arg.br.x; ++c) {
-                        int current = g2.get(r, c);
-                        if constexpr (std::is_same_v<T, Turn>) {
-                            g.set(r, c, arg.on);
-                            g2.set(r, c, std::max(0, current + (arg.on ? 1 : -1)));
-                        } else if constexpr (std::is_same_v<T, Toggle>) {
-                            g.set(r, c, !g.get(r, c));
-                            g2.set(r, c, current + 2);
-                        } else {
-                            throw std::runtime_error("Whoa, not a type we expected");
-                        }
+                        f(row[c], arg);
                     }
                 }
             },
             inst);
     }
+    return g;
+}
+
+int part1(const std::vector<Instruction> &instructions) {
+    auto g = apply<uint8_t>(instructions, [](uint8_t &lit, const auto &arg) {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, Turn>) {
+            lit = arg.on;
+        } else if constexpr (std::is_same_v<T, Toggle>) {
+            lit = !lit;
+        } else {
+            throw std::runtime_error("Whoa, not a type we expected");
+        }
+    });
+    return std::ranges::count(g.cells(), 1);
+}
+
+int part2(const std::vector<Instruction> &instructions) {
+    auto g = apply<int>(instructions, [](int &bright, const auto &arg) {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, Turn>) {
+            bright = std::max(0, bright + (arg.on ? 1 : -1));
+        } else if constexpr (std::is_same_v<T, Toggle>) {
+            bright += 2;
+        } else {
+            throw std::runtime_error("Whoa, not a type we expected");
+        }
+    });
+    return g.cells() | prelude::sum;
+}
 
-    int part1 = std::ranges::distance(g.elts() | rv::filter([](bool b) { return b; }));
-    fmt::print("part 1: {}\n", part1);
-    int part2 = g2.elts() | prelude::sum;
-    fmt::print("part 2: {}\n", part2);
+} // namespace
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2015, 6, parse, part1, part2);
\ No newline at end of file
@@ -0,0 +1,23 @@
+#include "prelude/gen.hpp"
+
+// The grid is fixed at 1000x1000 by the puzzle; what scales is the number of
+// instructions and how much of the grid each one covers.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 300l, "number of instructions");
+    const int side = args.get("side", 1000, "rectangles are at most side x side");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(side >= 1 && side <= 1000, "side must be in [1, 1000]");
+
+    constexpr std::string_view actions[] = {"turn on", "turn off", "toggle"};
+    for (long i = 0; i < n; ++i) {
+        const int x = rng.uniform(0, 999), y = rng.uniform(0, 999);
+        out.print("{} {},{} through {},{}\n", rng.pick(actions), x, y,
+                  std::min(999, x + rng.uniform(0, side - 1)),
+                  std::min(999, y + rng.uniform(0, side - 1)));
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2015 day 6: n light instructions.", generate);
+}
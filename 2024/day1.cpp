@@ -1,40 +1,48 @@
 #include <algorithm>
-#include <iostream>
 #include <map>
 #include <numeric>
-#include <sstream>
 #include <vector>
 
 #include <fmt/core.h>
 
+#include "prelude/aoc.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
+#include "prelude/sort.hpp"
 
-int main() {
+namespace {
+
+struct Lists {
     std::vector<int> left, right;
-    prelude::line_view lines{std::cin};
+};
 
-    prelude::line_view(std::cin) | rv::transform([](const std::string &line) {
-        int l = 0, r = 0;
-        std::stringstream(line) >> l >> r;
+// Both parts want the columns sorted, so that happens here.
+Lists parse(std::string_view input) {
+    Lists lists;
+    prelude::lines(input) | rv::transform([](std::string_view line) {
+        auto [l, r] = prelude::ints<2, int>(line);
         return std::pair<int, int>(l, r);
-    }) | prelude::for_each([&left, &right](const auto &p) {
-        left.push_back(p.first);
-        right.push_back(p.second);
+    }) | prelude::for_each([&lists](const auto &p) {
+        lists.left.push_back(p.first);
+        lists.right.push_back(p.second);
     });
 
-    std::sort(left.begin(), left.end());
-    std::sort(right.begin(), right.end());
-
-    auto part1 = rv::zip(left, right) | rv::transform([](const auto &tup) {
-                     auto &[a, b] = tup;
-                     return std::abs(a - b);
-                 })
-                 | prelude::sum;
+    prelude::radix_sort(lists.left);
+    prelude::radix_sort(lists.right);
+    return lists;
+}
 
-    fmt::print("part 1: {}\n", part1);
+int part1(const Lists &lists) {
+    return rv::zip(lists.left, lists.right) | rv::transform([](const auto &tup) {
+               auto &[a, b] = tup;
+               return std::abs(a - b);
+           })
+           | prelude::sum;
+}
 
-    auto lrl = prelude::run_length(left) | prelude::collect<std::vector>;
-    auto rrl = prelude::run_length(right) | prelude::collect<std::vector>;
+int part2(const Lists &lists) {
+    auto lrl = prelude::run_length(lists.left) | prelude::collect<std::vector>;
+    auto rrl = prelude::run_length(lists.right) | prelude::collect<std::vector>;
 
     int part2 = 0;
     for (size_t li = 0, ri = 0; li < lrl.size() && ri < rrl.size();) {
@@ -48,8 +56,9 @@ int main() {
             ++ri;
         }
     }
+    return part2;
+}
 
-    fmt::print("part 2: {}\n", part2);
+} // namespace
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2024, 1, parse, part1, part2);
\ No newline at end of file
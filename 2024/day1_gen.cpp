@@ -0,0 +1,17 @@
+#include "prelude/gen.hpp"
+
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 1000l, "number of lines");
+    const long max = args.get("max", 99999l, "ids are in [1, max]; smaller means more repeats");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(max >= 1, "max must be at least 1");
+
+    for (long i = 0; i < n; ++i) {
+        out.print("{}   {}\n", rng.uniform(1l, max), rng.uniform(1l, max));
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2024 day 1: two columns of n ids.", generate);
+}
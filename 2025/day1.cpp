@@ -1,26 +1,33 @@
-#include <iostream>
 #include <optional>
 #include <vector>
 
 #include <fmt/core.h>
 #include <spdlog/spdlog.h>
 
+#include "prelude/aoc.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
 
+namespace {
+
 constexpr int LOCK_SIZE = 100;
 
 int lock_mod(int x) { return (x % LOCK_SIZE + LOCK_SIZE) % LOCK_SIZE; }
 
-int turn_from_string(const std::string &s) {
-    int x = std::stoi(s.substr(1));
+int turn_from_string(std::string_view s) {
+    auto parsed = prelude::scan<"{}{}", char, int>(s);
+    if (!parsed) {
+        throw std::invalid_argument(fmt::format("malformed turn: {}", s));
+    }
+    auto [direction, x] = *parsed;
 
-    switch (s[0]) {
+    switch (direction) {
     case 'R':
         return x;
     case 'L':
         return -x;
     default:
-        throw std::invalid_argument(fmt::format("unrecognized prefix: {}", s[0]));
+        throw std::invalid_argument(fmt::format("unrecognized prefix: {}", direction));
     };
 }
 
@@ -29,26 +36,39 @@ int turn_from_string(const std::string &s) {
 // we go through otherwise for counting the times we pass zero.
 int full_turns(int x) { return std::abs(x / 100); }
 
-int main(int, char **) {
-    auto turns = prelude::line_view(std::cin) | rv::transform(turn_from_string);
+std::vector<int> parse(std::string_view input) {
+    return prelude::lines(input) | rv::transform(turn_from_string) | prelude::collect<std::vector>;
+}
+
+struct Clicks {
+    int stops = 0;  // times the dial lands on zero
+    int passes = 0; // times it goes through zero on the way somewhere else
+};
 
+Clicks spin(const std::vector<int> &turns) {
     int position = 50;
-    int part1 = 0;
-    int part2 = 0;
+    Clicks clicks;
     for (auto x : turns) {
-        part2 += full_turns(x);
+        clicks.passes += full_turns(x);
         x %= LOCK_SIZE;
         if (position != 0 && (position + x > LOCK_SIZE || position + x < 0)) {
-            ++part2;
+            ++clicks.passes;
         }
         position = lock_mod(position + x);
         if (position == 0) {
-            ++part1;
+            ++clicks.stops;
         }
     }
+    return clicks;
+}
+
+int part1(const std::vector<int> &turns) { return spin(turns).stops; }
+
+int part2(const std::vector<int> &turns) {
+    auto clicks = spin(turns);
+    return clicks.stops + clicks.passes;
+}
 
-    fmt::print("part 1: {}\n", part1);
-    fmt::print("part 2: {}\n", part1 + part2);
+} // namespace
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2025, 1, parse, part1, part2);
\ No newline at end of file
@@ -1,9 +1,15 @@
+#include "prelude/aoc.hpp"
+#include "prelude/hash.hpp"
+#include "prelude/input.hpp"
+#include "prelude/parallel.hpp"
 #include "prelude/prelude.hpp"
+#include "prelude/trace.hpp"
 #include <deque>
-#include <set>
 
 #include <z3++.h>
 
+namespace {
+
 struct Machine {
     short desiredState;
     std::vector<short> buttons;
@@ -21,16 +27,8 @@ short bits(const std::vector<bool> &bs) {
     return ret;
 }
 
-auto contained(const std::string &s) { return s.substr(1, s.size() - 2); }
-
-short stos(const std::string &s) { return static_cast<short>(std::stoi(s)); }
-
-std::vector<short> commaNums(const std::string &s) {
-    return rv::split(s, ',') | rv::transform([](const auto &&r) {
-               return std::string(std::ranges::begin(r), std::ranges::end(r));
-           })
-           | rv::transform([](const std::string &s) { return stos(s); })
-           | prelude::collect<std::vector>;
+std::vector<short> commaNums(std::string_view s) {
+    return prelude::ints<short>(s) | prelude::collect<std::vector>;
 }
 
 short makeButton(const std::vector<short> &ns) {
@@ -41,28 +39,29 @@ short makeButton(const std::vector<short> &ns) {
     return ret;
 }
 
-Machine fromString(const std::string &line) {
-    Machine m;
-    auto parts = rv::split(line, ' ') | rv::transform([](auto &&r) {
-                     return std::string(std::ranges::begin(r), std::ranges::end(r));
-                 })
-                 | prelude::collect<std::vector>;
+Machine fromString(std::string_view line) {
+    auto parsed = prelude::scan<"[{}] {} {{{}}}">(line);
+    if (!parsed) {
+        throw std::invalid_argument(fmt::format("malformed machine: {}", line));
+    }
+    auto [lights, buttons, joltage] = *parsed;
 
-    m.desiredState
-        = bits(contained(parts.front()) | rv::transform([](const char ch) { return ch == '#'; })
-               | prelude::collect<std::vector>);
+    Machine m;
+    m.desiredState = bits(lights | rv::transform([](const char ch) { return ch == '#'; })
+                          | prelude::collect<std::vector>);
 
-    for (size_t i = 1; i < parts.size() - 1; ++i) {
-        m.numButtons.push_back(commaNums(contained(parts[i])));
+    for (auto &&button : buttons | rv::split(' ')) {
+        m.numButtons.push_back(commaNums(std::string_view(button.begin(), button.end())));
         m.buttons.push_back(makeButton(m.numButtons.back()));
     }
-    m.joltageRequirement = commaNums(contained(parts.back()));
+    m.joltageRequirement = commaNums(joltage);
 
     return m;
 };
 
 long calcMachine1(const Machine &machine) {
-    std::set<short> seen;
+    AOC_TRACE_SPAN("calcMachine1", "buttons", static_cast<long>(machine.buttons.size()));
+    prelude::flat_set<short> seen;
     std::deque<std::pair<short, long>> q;
 
     q.push_back({0, 0});
@@ -70,10 +69,9 @@ long calcMachine1(const Machine &machine) {
     while (0 < q.size()) {
         auto [state, presses] = q.back();
         q.pop_back();
-        if (seen.contains(state)) {
+        if (!seen.insert(state).second) {
             continue;
         }
-        seen.insert(state);
         for (auto button : machine.buttons) {
             auto current = state ^ button;
             if (current == machine.desiredState) {
@@ -85,24 +83,14 @@ long calcMachine1(const Machine &machine) {
     return -1;
 }
 
-std::vector<long> press(const std::vector<long> &start, short button) {
-    std::vector<long> current = start;
-    int i = 0;
-    while (button > 0) {
-        if (button & 1) {
-            current[i]++;
-        }
-        button /= 2;
-        ++i;
-    }
-    return current;
-}
-
 int calcMachine2(const Machine &machine) {
     const int N = machine.joltageRequirement.size();
     const int M = machine.numButtons.size();
+    AOC_TRACE_SPAN("calcMachine2", "buttons", M);
 
-    z3::context c;
+    // A context is costly to make and can't be shared between threads, so
+    // each thread keeps one for every machine (and every input) it solves.
+    thread_local z3::context c;
 
     std::vector<std::vector<int>> B(N, std::vector<int>(M, 0));
 
@@ -148,21 +136,76 @@ int calcMachine2(const Machine &machine) {
 }
 
 long calc_part1(const std::vector<Machine> &machines) {
-    return machines | rv::transform(calcMachine1) | prelude::sum;
+    return machines | rv::transform(calcMachine1) | prelude::par_sum;
 }
 
 int calc_part2(const std::vector<Machine> &machines) {
-    return machines | rv::transform(calcMachine2) | prelude::sum;
+    return machines | rv::transform(calcMachine2) | prelude::par_sum;
+}
+
+std::vector<Machine> parse(std::string_view input) {
+    return prelude::lines(input) | rv::transform(fromString) | prelude::collect<std::vector>;
+}
+
+// A column per field, but the buttons' bitmasks, which load() remakes from
+// their lists so the two parts can't be given different machines.
+// numButtons is a list of lists per machine, so it goes in as one list per
+// button, every machine's end to end, with a column of how many buttons each
+// machine has to cut it back up by.
+void save(const std::vector<Machine> &machines, prelude::column_writer &out) {
+    std::vector<uint32_t> counts;
+    for (const auto &m : machines) {
+        counts.push_back(static_cast<uint32_t>(m.numButtons.size()));
+    }
+    out.column(machines | rv::transform(&Machine::desiredState) | prelude::collect<std::vector>);
+    out.column(counts);
+    out.ragged(machines | rv::transform(&Machine::numButtons) | rv::join);
+    out.ragged(machines | rv::transform(&Machine::joltageRequirement));
 }
 
-int main(int, char **) {
-    auto machines
-        = prelude::line_view(std::cin) | rv::transform(fromString) | prelude::collect<std::vector>;
+// calcMachine2 indexes joltages by the buttons' lists without looking, and a
+// button is a bit of a short, so a file that didn't come from save() has to
+// have every light a button toggles below both.
+std::vector<Machine> load(prelude::column_reader &in) {
+    auto fail = [](const std::string &why) {
+        throw std::runtime_error("columnar input: " + why);
+    };
+    auto states = in.column<short>();
+    auto counts = in.column<uint32_t>();
+    auto numButtons = in.ragged<short>();
+    auto joltages = in.ragged<short>();
+    if (counts.size() != states.size() || joltages.size() != states.size()) {
+        fail("columns for different numbers of machines");
+    }
+    std::vector<Machine> machines(states.size());
+    size_t next = 0;
+    for (size_t i = 0; i < machines.size(); ++i) {
+        auto &m = machines[i];
+        m.desiredState = states[i];
+        m.joltageRequirement.assign(joltages[i].begin(), joltages[i].end());
+        if (numButtons.size() - next < counts[i]) {
+            fail("too few button lists");
+        }
+        const size_t lights = std::min<size_t>(m.joltageRequirement.size(), 16);
+        for (auto ns : std::span(numButtons).subspan(next, counts[i])) {
+            for (short n : ns) {
+                if (n < 0 || static_cast<size_t>(n) >= lights) {
+                    fail(fmt::format("machine {} has a button for light {}, of {}", i, n, lights));
+                }
+            }
+            m.numButtons.emplace_back(ns.begin(), ns.end());
+            m.buttons.push_back(makeButton(m.numButtons.back()));
+        }
+        next += counts[i];
+    }
+    if (next != numButtons.size()) {
+        fail(fmt::format("{} button lists left over", numButtons.size() - next));
+    }
+    return machines;
+}
 
-    long part1 = calc_part1(machines);
-    fmt::print("part 1: {}\n", part1);
+} // namespace
 
-    int part2 = calc_part2(machines);
-    fmt::print("part 2: {}\n", part2);
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2025, 10, parse, calc_part1, calc_part2);
+AOC_SOLUTION_COLUMNS(2025, 10, save, load);
+AOC_SOLUTION_VERSION(2025, 10, 2);
\ No newline at end of file
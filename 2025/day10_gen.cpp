@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <vector>
+
+#include <fmt/ranges.h>
+
+#include "prelude/gen.hpp"
+
+// Every machine is solvable by construction: the lights are the XOR of a
+// random set of buttons and the joltages are a random number of presses of
+// each button added up.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long machines = args.get("machines", 180l, "number of machines");
+    const int lights = args.get("lights", 10, "machines have 3 to this many lights (at most 15)");
+    const int buttons = args.get("buttons", 13, "machines have 2 to this many buttons");
+    const int presses = args.get("presses", 20, "each button is pressed up to this often");
+    prelude::rng rng(args.seed());
+    args.done();
+    // day10 keeps a machine's lights as the bits of a short.
+    args.check(lights >= 3 && lights <= 15 && buttons >= 2,
+               "need 3 <= lights <= 15 and buttons >= 2");
+    args.check(presses >= 0, "presses can't be negative");
+
+    for (long m = 0; m < machines; ++m) {
+        const int nl = rng.uniform(3, lights);
+        const int nb = rng.uniform(2, buttons);
+
+        std::vector<std::vector<int>> wiring(nb);
+        std::vector<bool> covered(nl);
+        for (auto &w : wiring) {
+            for (int l = 0; l < nl; ++l) {
+                if (rng.chance(0.4)) {
+                    w.push_back(l);
+                    covered[l] = true;
+                }
+            }
+            if (w.empty()) {
+                w.push_back(rng.uniform(0, nl - 1));
+                covered[w.back()] = true;
+            }
+        }
+        // a light no button reaches could never change
+        for (int l = 0; l < nl; ++l) {
+            if (!covered[l]) {
+                auto &w = rng.pick(wiring);
+                w.insert(std::ranges::lower_bound(w, l), l);
+            }
+        }
+
+        std::vector<bool> on(nl);
+        std::vector<long> joltage(nl);
+        for (const auto &w : wiring) {
+            const bool toggled = rng.chance(0.5);
+            const long times = rng.uniform(0, presses);
+            for (int l : w) {
+                on[l] = on[l] != toggled;
+                joltage[l] += times;
+            }
+        }
+
+        out.put('[');
+        for (bool b : on) {
+            out.put(b ? '#' : '.');
+        }
+        out.put(']');
+        for (const auto &w : wiring) {
+            out.print(" ({})", fmt::join(w, ","));
+        }
+        out.print(" {{{}}}\n", fmt::join(joltage, ","));
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 10: machines with lights and buttons.",
+                             generate);
+}
@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "prelude/aoc.hpp"
+#include "prelude/columnar.hpp"
+
+namespace {
+
+const prelude::solution &day10() {
+    for (const auto &s : prelude::registry()) {
+        if (s.year == 2025 && s.day == 10) {
+            return s;
+        }
+    }
+    throw std::logic_error("2025 day 10 isn't registered");
+}
+
+using Lists = std::vector<std::vector<short>>;
+
+// What save() writes, given each column as it goes in.
+std::string columns(const std::vector<short> &states, const std::vector<uint32_t> &counts,
+                    const Lists &buttons, const Lists &joltages) {
+    prelude::column_writer out;
+    out.column(states);
+    out.column(counts);
+    out.ragged(buttons);
+    out.ragged(joltages);
+    return out.bytes(2025, 10, day10().version);
+}
+
+// The first machine of the puzzle's example.
+const std::string text = "[.##.] (3) (1,3) (2) (2,3) (0,2) (0,1) {3,5,4,7}\n";
+const Lists buttons = {{3}, {1, 3}, {2}, {2, 3}, {0, 2}, {0, 1}};
+const Lists joltages = {{3, 5, 4, 7}};
+
+} // namespace
+
+TEST(Day10Test, TestColumns) {
+    const auto &s = day10();
+    const auto solved = prelude::solve(s, text);
+    const auto loaded = prelude::solve(s, columns({0b0110}, {6}, buttons, joltages));
+    EXPECT_EQ(loaded.part1, solved.part1);
+    EXPECT_EQ(loaded.part2, solved.part2);
+    EXPECT_EQ(prelude::solve(s, prelude::to_columnar(s, text)).part2, solved.part2);
+}
+
+TEST(Day10Test, TestBadColumns) {
+    const auto &s = day10();
+    auto bad = [&](const std::string &file) {
+        EXPECT_THROW(prelude::solve(s, file), std::runtime_error);
+    };
+
+    // a light below 0, a light past the joltages, and one past what a short
+    // button holds
+    bad(columns({0b0110}, {6}, {{3}, {1, 3}, {2}, {2, 3}, {0, 2}, {-1, 1}}, joltages));
+    bad(columns({0b0110}, {6}, {{3}, {1, 3}, {2}, {2, 4}, {0, 2}, {0, 1}}, joltages));
+    bad(columns({1}, {1}, {{16}}, {std::vector<short>(17, 1)}));
+
+    // too few button lists, some left over, and columns that disagree on how
+    // many machines there are
+    bad(columns({0b0110}, {7}, buttons, joltages));
+    bad(columns({0b0110}, {5}, buttons, joltages));
+    bad(columns({0b0110}, {6, 0}, buttons, joltages));
+    bad(columns({0b0110, 0}, {6, 0}, buttons, joltages));
+}
@@ -1,18 +1,25 @@
+#include "prelude/aoc.hpp"
+#include "prelude/hash.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
 
-using Graph = std::map<std::string, std::vector<std::string>>;
+namespace {
+
+using Graph = prelude::flat_map<std::string, std::vector<std::string>>;
 
 class DFS {
   private:
+    // n views a name owned by the graph (or a literal), so keys are cheap
     struct key {
-        std::string n;
+        std::string_view n;
         bool dac = false;
         bool fft = false;
 
-        auto operator<=>(const key &) const = default;
+        bool operator==(const key &) const = default;
+        friend size_t hash_value(const key &k) { return prelude::hash_fields(k.n, k.dac, k.fft); }
     };
 
-    std::map<key, long> _memo;
+    prelude::flat_map<key, long> _memo;
     const Graph &g;
 
   public:
@@ -20,8 +27,7 @@ class DFS {
 
     void clear() { _memo.clear(); }
 
-    long dfs(const std::string &start, const std::string &dest, bool dac = false,
-             bool fft = false) {
+    long dfs(std::string_view start, std::string_view dest, bool dac = false, bool fft = false) {
         if (start == dest) {
             return (dac && fft) ? 1 : 0;
         } else if (start == "dac") {
@@ -31,41 +37,36 @@ class DFS {
         }
         key k{start, dac, fft};
 
-        auto found = _memo.find(k);
-        if (found == _memo.end()) {
-            long tmp = 0;
-            for (auto n : g.at(start)) {
-                tmp += dfs(n, dest, dac, fft);
-            }
-            _memo[k] = tmp;
-            auto [it, inserted] = _memo.insert(std::make_pair(k, tmp));
-            if (inserted) {
-                found = it;
-            }
+        if (auto found = _memo.find(k); found != _memo.end()) {
+            return found->second;
+        }
+        long paths = 0;
+        for (const auto &n : g.at(start)) {
+            paths += dfs(n, dest, dac, fft);
         }
-        return _memo[k];
+        // not through a reference from before the loop: the recursion grows the table
+        _memo.try_emplace(k, paths);
+        return paths;
     }
 };
 
-int main(int, char **) {
+Graph parse(std::string_view input) {
     Graph g;
-
-    for (auto &&r : prelude::line_view(std::cin)) {
-        std::string line(std::ranges::begin(r), std::ranges::end(r));
-        auto parts
-            = line | rv::split(' ')
-              | rv::transform([](auto &&r) { return std::string(std::begin(r), std::end(r)); })
-              | prelude::collect<std::vector>;
-        const auto name = parts[0].substr(0, 3);
-        g[name].assign(std::ranges::next(std::ranges::begin(parts)), std::ranges::end(parts));
+    for (auto line : prelude::lines(input)) {
+        auto parsed = prelude::scan<"{}: {}">(line);
+        if (!parsed) {
+            throw std::invalid_argument(fmt::format("malformed node: {}", line));
+        }
+        auto [name, outputs] = *parsed;
+        auto ws = prelude::tokens(outputs);
+        g[name].assign(ws.begin(), ws.end());
     }
+    return g;
+}
 
-    DFS dfs(g);
-    auto part1 = dfs.dfs("you", "out", true, true);
-    fmt::print("part 1: {}\n", part1);
+long part1(const Graph &g) { return DFS(g).dfs("you", "out", true, true); }
+long part2(const Graph &g) { return DFS(g).dfs("svr", "out", false, false); }
 
-    dfs.clear();
-    auto part2 = dfs.dfs("svr", "out", false, false);
-    fmt::print("part 2: {}\n", part2);
-    return 0;
-}
+} // namespace
+
+AOC_SOLUTION(2025, 11, parse, part1, part2);
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "prelude/gen.hpp"
+
+// A random DAG: the devices are put in a random order and every one but out
+// gets edges only to devices later in it, so everything ends up at out. With
+// targets picked uniformly the path counts grow about like n^(degree / 2),
+// which stays well inside a long. svr -> fft -> dac is wired in so part 2
+// always has an answer.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 600l, "number of devices, counting you, svr, fft, dac and out");
+    const int degree = args.get("degree", 3, "devices have 1 to this many outputs");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(n >= 6, "n must be at least 6");
+    args.check(degree >= 1, "degree must be at least 1");
+
+    const std::vector<std::string> reserved = {"you", "svr", "fft", "dac", "out"};
+    int len = 3;
+    for (long cap = 26 * 26 * 26; cap < n + 5; cap *= 26) {
+        ++len;
+    }
+    std::vector<std::string> names;
+    for (long i = 0; static_cast<long>(names.size()) < n - 5; ++i) {
+        std::string name(len, 'a');
+        for (long j = len - 1, x = i; j >= 0; --j, x /= 26) {
+            name[j] = static_cast<char>('a' + x % 26);
+        }
+        if (std::ranges::find(reserved, name) == reserved.end()) {
+            names.push_back(std::move(name));
+        }
+    }
+    rng.shuffle(names);
+
+    // svr first, out last, fft and dac a third and two thirds of the way in
+    names.insert(names.begin(), "svr");
+    names.insert(names.begin() + n / 3, "fft");
+    names.insert(names.begin() + std::min<long>(2 * n / 3, names.size()), "dac");
+    names.insert(names.begin() + rng.uniform(1l, n - 3), "you");
+    names.push_back("out");
+    const long fft = std::ranges::find(names, "fft") - names.begin();
+    const long dac = std::ranges::find(names, "dac") - names.begin();
+
+    std::vector<long> order(n - 1);
+    for (long i = 0; i < n - 1; ++i) {
+        order[i] = i;
+    }
+    rng.shuffle(order);
+
+    std::vector<long> outputs;
+    for (long i : order) {
+        outputs.clear();
+        if (i == 0) {
+            outputs.push_back(fft);
+        } else if (i == fft) {
+            outputs.push_back(dac);
+        }
+        const int d = rng.uniform(1, degree);
+        while (static_cast<int>(outputs.size()) < std::min<long>(d, n - 1 - i)) {
+            const long to = rng.uniform(i + 1, n - 1);
+            if (std::ranges::find(outputs, to) == outputs.end()) {
+                outputs.push_back(to);
+            }
+        }
+        out.print("{}:", names[i]);
+        for (long to : outputs) {
+            out.print(" {}", names[to]);
+        }
+        out.put('\n');
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 11: a network of devices.", generate);
+}
@@ -1,46 +1,40 @@
+#include "prelude/aoc.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
 
 #include <array>
+#include <stdexcept>
+#include <string_view>
 #include <vector>
 
-using std::operator""sv;
+namespace {
 
 using shape = std::array<bool, 9>;
 
-int count(const shape &s) {
-    int ret = 0;
-    for (auto &b : s) {
-        if (b) {
-            ++ret;
-        }
-    }
-    return ret;
-}
-
 struct Problem {
     int width, height;
     std::vector<int> counts;
 };
 
-Problem fromLine(const std::string &s) {
+// "WxH: c0 c1 ..." into p's width and height, handing each count to add.
+template <typename P, typename F> constexpr void readLine(std::string_view s, P &p, F add) {
+    auto nums = prelude::ints<int>(s);
+    auto it = nums.begin();
+    p.width = *it++;
+    p.height = *it++;
+    for (; it != nums.end(); ++it) {
+        add(*it);
+    }
+}
+
+Problem fromLine(std::string_view s) {
     Problem p;
-    std::vector<std::string> halves
-        = rv::split(s, ": "sv)
-          | rv::transform([](const auto &r) { return std::string(r.begin(), r.end()); })
-          | prelude::collect<std::vector>;
-    std::vector<int> dimensions
-        = rv::split(halves[0], "x"sv)
-          | rv::transform([](const auto &r) { return std::stoi(std::string(r.begin(), r.end())); })
-          | prelude::collect<std::vector>;
-    p.width = dimensions[0];
-    p.height = dimensions[1];
-    p.counts
-        = prelude::split_ws(halves[1])
-          | rv::transform([](const auto &r) { return std::stoi(std::string(r.begin(), r.end())); })
-          | prelude::collect<std::vector>;
+    readLine(s, p, [&p](int c) { p.counts.push_back(c); });
     return p;
 }
 
+} // namespace
+
 template <> struct fmt::formatter<Problem> : fmt::formatter<std::string_view> {
     auto format(const Problem &p, fmt::format_context &ctx) const {
         std::string s = fmt::format("{}x{}", p.width, p.height);
@@ -51,6 +45,8 @@ template <> struct fmt::formatter<Problem> : fmt::formatter<std::string_view> {
     }
 };
 
+namespace {
+
 long calc_part1(const std::vector<shape> &shapes, const std::vector<Problem> &problems) {
     return problems | rv::transform([shapes](const Problem &p) {
                int area = p.width * p.height;
@@ -64,26 +60,87 @@ long calc_part1(const std::vector<shape> &shapes, const std::vector<Problem> &pr
            | prelude::sum;
 }
 
-int main(int, char **) {
-    auto lines = prelude::line_view(std::cin) | prelude::collect<std::vector>;
+struct Puzzle {
     std::vector<shape> shapes;
+    std::vector<Problem> problems;
+};
 
-    // lordy lordy I apologize for being this cheesy I just want to finish.
-    for (int i = 0; i < 5; ++i) {
-        shape s;
+// lordy lordy I apologize for being this cheesy I just want to finish.
+constexpr std::array<shape, 5> parseShapes(std::string_view input) {
+    std::array<shape, 5> shapes{};
+    auto line = prelude::lines(input).begin();
+    for (auto &s : shapes) {
+        ++line; // its number
         int idx = 0;
-        for (int j = 0; j < 3; ++j) {
-            const auto &line = lines[1 + j + 5 * i];
-            for (auto x : line) {
+        for (int j = 0; j < 3; ++j, ++line) {
+            for (auto x : *line) {
                 s[idx++] = x == '#';
             }
         }
-        shapes.push_back(s);
+        ++line; // the blank after it
+    }
+    return shapes;
+}
+
+Puzzle parse(std::string_view input) {
+    auto lines = prelude::lines(input) | prelude::collect<std::vector>;
+    Puzzle puzzle;
+    auto shapes = parseShapes(input);
+    puzzle.shapes.assign(shapes.begin(), shapes.end());
+
+    puzzle.problems = std::ranges::drop_view(lines, 30) | rv::transform(fromLine)
+                      | prelude::collect<std::vector>;
+    return puzzle;
+}
+
+long part1(const Puzzle &puzzle) { return calc_part1(puzzle.shapes, puzzle.problems); }
+
+#ifdef AOC_EMBEDDED_INPUT
+// A Problem with its counts in place, so the compiler can make a table of them.
+struct FixedProblem {
+    int width = 0, height = 0;
+    std::array<int, 8> counts{};
+    size_t n = 0;
+};
+
+constexpr FixedProblem fixedFromLine(std::string_view s) {
+    FixedProblem p;
+    readLine(s, p, [&p](int c) {
+        if (p.n == p.counts.size()) {
+            throw std::invalid_argument("too many counts for FixedProblem");
+        }
+        p.counts[p.n++] = c;
+    });
+    return p;
+}
+
+// The input from its 31st line on, where the problems start.
+constexpr std::string_view problemLines(std::string_view input) {
+    auto line = prelude::lines(input).begin();
+    for (int i = 0; i < 30; ++i) {
+        ++line;
     }
+    return input.substr(static_cast<size_t>((*line).data() - input.data()));
+}
+
+constexpr auto embedded_shapes = parseShapes(prelude::embedded_input);
+constexpr auto embedded_problems = prelude::map_lines<prelude::embedded_lines - 30>(
+    problemLines(prelude::embedded_input), fixedFromLine);
+
+Puzzle embedded() {
+    Puzzle puzzle;
+    puzzle.shapes.assign(embedded_shapes.begin(), embedded_shapes.end());
+    for (const auto &p : embedded_problems) {
+        puzzle.problems.push_back(
+            {p.width, p.height, std::vector<int>(p.counts.begin(), p.counts.begin() + p.n)});
+    }
+    return puzzle;
+}
+#endif
 
-    std::vector<Problem> problems = std::ranges::drop_view(lines, 30) | rv::transform(fromLine)
-                                    | prelude::collect<std::vector>;
+} // namespace
 
-    long part1 = calc_part1(shapes, problems);
-    fmt::print("part 1: {}\n", part1);
-}
\ No newline at end of file
+AOC_SOLUTION(2025, 12, parse, part1);
+#ifdef AOC_EMBEDDED_INPUT
+AOC_SOLUTION_EMBEDDED(2025, 12, embedded);
+#endif
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include <fmt/ranges.h>
+
+#include "prelude/gen.hpp"
+
+// Regions are packed to somewhere between half and 120% of what their area
+// could hold, so some fit easily and some can't fit at all.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long regions = args.get("regions", 1000l, "number of regions");
+    const int min_side = args.get("min-side", 35, "smallest region side");
+    const int max_side = args.get("max-side", 50, "largest region side");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(3 <= min_side && min_side <= max_side, "need 3 <= min-side <= max-side");
+
+    constexpr int shapes = 6;
+    for (int s = 0; s < shapes; ++s) {
+        out.print("{}:\n", s);
+        const int filled = rng.uniform(0, 8); // at least one cell per shape
+        for (int i = 0; i < 9; ++i) {
+            out.put(i == filled || rng.chance(0.7) ? '#' : '.');
+            if (i % 3 == 2) {
+                out.put('\n');
+            }
+        }
+        out.put('\n');
+    }
+
+    for (long r = 0; r < regions; ++r) {
+        const int w = rng.uniform(min_side, max_side);
+        const int h = rng.uniform(min_side, max_side);
+        const long presents = static_cast<long>((0.5 + 0.7 * rng.real()) * (w / 3) * (h / 3));
+        int counts[shapes] = {};
+        for (long p = 0; p < presents; ++p) {
+            ++counts[rng.uniform(0, shapes - 1)];
+        }
+        out.print("{}x{}: {}\n", w, h, fmt::join(counts, " "));
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 12: presents and regions under trees.",
+                             generate);
+}
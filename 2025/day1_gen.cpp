@@ -0,0 +1,17 @@
+#include "prelude/gen.hpp"
+
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 4000l, "number of rotations");
+    const long max = args.get("max", 999l, "each rotation is [1, max] clicks");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(max >= 1, "max must be at least 1");
+
+    for (long i = 0; i < n; ++i) {
+        out.print("{}{}\n", rng.chance(0.5) ? 'L' : 'R', rng.uniform(1l, max));
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 1: n dial rotations.", generate);
+}
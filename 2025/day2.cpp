@@ -1,11 +1,13 @@
-#include <iostream>
 #include <vector>
 
 #include <fmt/core.h>
 #include <spdlog/spdlog.h>
 
+#include "prelude/aoc.hpp"
 #include "prelude/prelude.hpp"
 
+namespace {
+
 using namespace std::literals;
 
 bool doubleseq(long n) {
@@ -51,31 +53,38 @@ bool repeatedDigits(long n) {
     return false;
 }
 
-int main(int, char **) {
-    std::string line;
-    std::getline(std::cin, line);
-    auto inputs = std::views::all(line) | std::views::split(","sv) | rv::transform([](auto &&r) {
-                      auto dash = std::ranges::find(r, '-');
-                      auto a = std::string(std::ranges::begin(r), dash);
-                      auto b = std::string(std::ranges::next(dash), std::ranges::end(r));
-                      return std::make_pair(std::stol(a), std::stol(b));
-                  });
+std::vector<std::pair<long, long>> parse(std::string_view input) {
+    return prelude::chomp(input) | std::views::split(","sv) | rv::transform([](auto &&r) {
+               auto [a, b] = prelude::ints<2>(std::string_view(r.begin(), r.end()));
+               return std::make_pair(a, b);
+           })
+           | prelude::collect<std::vector>;
+}
 
+long part1(const std::vector<std::pair<long, long>> &inputs) {
     long part1 = 0;
-    long part2 = 0;
     for (auto &&p : inputs) {
         for (long i = p.first; i <= p.second; ++i) {
             if (doubleseq(i)) {
                 part1 += i;
             }
+        }
+    }
+    return part1;
+}
+
+long part2(const std::vector<std::pair<long, long>> &inputs) {
+    long part2 = 0;
+    for (auto &&p : inputs) {
+        for (long i = p.first; i <= p.second; ++i) {
             if (repeatedDigits(i)) {
                 part2 += i;
             }
         }
     }
+    return part2;
+}
 
-    fmt::print("part 1: {}\n", part1);
-    fmt::print("part 2: {}\n", part2);
+} // namespace
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2025, 2, parse, part1, part2);
\ No newline at end of file
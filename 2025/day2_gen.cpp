@@ -0,0 +1,39 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "prelude/gen.hpp"
+
+// Both parts walk every id in every range, so total width is the cost.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 40l, "number of ranges");
+    const long width = args.get("width", 100000l, "ranges cover at most this many ids");
+    const long max = args.get("max", 10000000000l, "ids are in [1, max]");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(n >= 1 && width >= 1, "n and width must be at least 1");
+    args.check(max >= n, "max has to leave room for n ranges");
+
+    std::vector<long> starts(n);
+    for (auto &s : starts) {
+        s = rng.uniform(1l, max);
+    }
+    std::ranges::sort(starts);
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+
+    std::vector<std::pair<long, long>> ranges;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        const long limit = i + 1 < starts.size() ? starts[i + 1] - 1 : max;
+        ranges.emplace_back(starts[i], std::min(limit, starts[i] + rng.uniform(0l, width - 1)));
+    }
+    rng.shuffle(ranges);
+
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        out.print("{}{}-{}", i == 0 ? "" : ",", ranges[i].first, ranges[i].second);
+    }
+    out.put('\n');
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 2: n disjoint id ranges.", generate);
+}
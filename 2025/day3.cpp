@@ -1,6 +1,14 @@
+#include "prelude/aoc.hpp"
+#include "prelude/arena.hpp"
+#include "prelude/input.hpp"
+#include "prelude/parallel.hpp"
 #include "prelude/prelude.hpp"
 
-long largest_subsequence(const std::vector<int> &v, int k) {
+namespace {
+
+using Banks = prelude::pmr::vector<prelude::pmr::vector<int>>;
+
+long largest_subsequence(std::span<const int> v, int k) {
     int n = v.size();
     int to_remove = n - k;
 
@@ -20,19 +28,25 @@ long largest_subsequence(const std::vector<int> &v, int k) {
     return result | prelude::reduce(0l, [](long a, int b) { return 10 * a + b; });
 }
 
-int main(int, char **) {
-    auto data = prelude::line_view(std::cin) | rv::transform([](const auto &line) {
-                    return line | rv::transform([](const char ch) { return int(ch - '0'); })
-                           | prelude::collect<std::vector>;
-                })
-                | prelude::collect<std::vector>;
-
-    long part1 = data | rv::transform([](const auto &v) { return largest_subsequence(v, 2); })
-                 | prelude::sum;
-    long part2 = data | rv::transform([](const auto &v) { return largest_subsequence(v, 12); })
-                 | prelude::sum;
-
-    fmt::print("Part 1: {}\n", part1);
-    fmt::print("Part 2: {}\n", part2);
-    return 0;
-}
\ No newline at end of file
+// Thousands of short rows: build them all in the run's arena.
+Banks parse(std::string_view input, std::pmr::memory_resource *mr) {
+    return prelude::lines(input) | rv::transform([mr](std::string_view line) {
+               return line | rv::transform([](const char ch) { return int(ch - '0'); })
+                      | prelude::collect<prelude::pmr::vector>(mr);
+           })
+           | prelude::collect<prelude::pmr::vector>(mr);
+}
+
+long part1(const Banks &data) {
+    return data | rv::transform([](const auto &v) { return largest_subsequence(v, 2); })
+           | prelude::par_sum;
+}
+
+long part2(const Banks &data) {
+    return data | rv::transform([](const auto &v) { return largest_subsequence(v, 12); })
+           | prelude::par_sum;
+}
+
+} // namespace
+
+AOC_SOLUTION(2025, 3, parse, part1, part2);
\ No newline at end of file
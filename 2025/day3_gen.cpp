@@ -0,0 +1,20 @@
+#include "prelude/gen.hpp"
+
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 200l, "number of banks");
+    const long len = args.get("len", 100l, "batteries per bank");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(len >= 12, "part 2 turns on 12 batteries, so len must be at least 12");
+
+    for (long i = 0; i < n; ++i) {
+        for (long j = 0; j < len; ++j) {
+            out.put(static_cast<char>('0' + rng.uniform(1, 9)));
+        }
+        out.put('\n');
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 3: n battery banks.", generate);
+}
@@ -1,6 +1,16 @@
+#include "prelude/aoc.hpp"
+#include "prelude/arena.hpp"
+#include "prelude/grid.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
+#include "prelude/simd.hpp"
 
-enum GridState { EMPTY = 0, ROLL = 1 };
+namespace {
+
+// a byte per cell, so a vector holds a whole run of the row
+enum GridState : uint8_t { EMPTY = 0, ROLL = 1 };
+
+} // namespace
 
 template <> struct fmt::formatter<GridState> : fmt::formatter<std::string_view> {
     auto format(const GridState &p, fmt::format_context &ctx) const {
@@ -9,72 +19,9 @@ template <> struct fmt::formatter<GridState> : fmt::formatter<std::string_view>
     }
 };
 
-template <typename T> class Grid {
-  private:
-    std::vector<std::vector<T>> _elts;
-    int _rows, _cols;
-
-  public:
-    Grid(const std::vector<std::vector<T>> &elts)
-        : _elts(std::move(elts)), _rows(_elts.size()), _cols(elts[0].size()) {}
-
-    int rows() const { return _rows; }
-    int cols() const { return _cols; }
-
-    void set(const int r, const int c, const T &t) { _elts[r][c] = t; }
-
-    struct Coord {
-        int row, col;
-    };
-    struct Point {
-        int row, col;
-        T ref;
-    };
-
-    auto elts() const noexcept {
-        return _elts | rv::enumerate | rv::transform([](auto &&rowpair) {
-                   const auto [r, row] = rowpair;
-                   return row | rv::enumerate | rv::transform([r](auto &&colpair) {
-                              const auto [c, elt] = colpair;
-                              Point point{static_cast<int>(r), static_cast<int>(c), elt};
-                              return point;
-                          });
-               })
-               | rv::join;
-    }
-
-    const T &at(int r, int c) const { return _elts.at(r).at(c); }
-
-    static constexpr std::array<Coord, 9> deltas{
-        {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 0}, {0, 1}, {1, -1}, {1, 0}, {1, 1}}};
-
-    auto neighbors(int r, int c) const {
-        return deltas | rv::transform([r, c](const Coord &coord) {
-                   return Coord{r + coord.row, c + coord.col};
-               })
-               | rv::filter([this](const Coord cc) {
-                     return cc.row >= 0 && cc.row < _rows && cc.col >= 0 && cc.col < _cols;
-                 })
-               | rv::transform(
-                   [this](const Coord &c) { return Point{c.row, c.col, _elts[c.row][c.col]}; });
-    }
-};
+namespace {
 
-template <typename T> struct fmt::formatter<Grid<T>> : fmt::formatter<std::string_view> {
-    auto format(const Grid<T> &g, fmt::format_context &ctx) const {
-        std::string s;
-        s.reserve((1 + g.rows()) + g.cols());
-        for (int r = 0; r < g.rows(); ++r) {
-            for (int c = 0; c < g.cols(); ++c) {
-                s.append(fmt::format("{}", g.at(r, c)));
-            }
-            s.push_back('\n');
-        }
-        return fmt::formatter<std::string_view>::format(s, ctx);
-    }
-};
-
-static GridState fromChar(const char ch) {
+GridState fromChar(const char ch) {
     switch (ch) {
     case '@':
         return GridState::ROLL;
@@ -83,53 +30,72 @@ static GridState fromChar(const char ch) {
     }
 }
 
-using G = Grid<GridState>;
+using G = prelude::pmr::Grid<GridState>;
 
-int fullNeighbors(const G &grid, const G::Point &p) {
-    return grid.neighbors(p.row, p.col)
-           | rv::transform([](const auto &p) { return p.ref == GridState::ROLL ? 1 : 0; })
-           | prelude::sum;
+struct Coord {
+    int row, col;
+};
+
+// rolls with fewer than four rolls around them, into ret (cleared first)
+void removable(const G &grid, std::vector<Coord> &ret) {
+    ret.clear();
+    prelude::simd::dispatch(
+        []<size_t W>(const G &grid, std::vector<Coord> &ret) {
+            const std::ptrdiff_t s = grid.stride();
+            for (int r = 0; r < grid.rows(); ++r) {
+                int c = 0;
+                if constexpr (W > 0) {
+                    // cells are 0 or 1, so the neighbor count is the sum of
+                    // the eight shifted rows; the halo covers the edges
+                    using V = prelude::simd::vec<uint8_t, W>;
+                    for (; c + static_cast<int>(W) <= grid.cols(); c += W) {
+                        const GridState *p = &grid(r, c);
+                        const V n = V::load(p - s - 1) + V::load(p - s) + V::load(p - s + 1)
+                                    + V::load(p - 1) + V::load(p + 1) + V::load(p + s - 1)
+                                    + V::load(p + s) + V::load(p + s + 1);
+                        const auto m = (V::load(p) == GridState::ROLL) & (n < 4);
+                        prelude::simd::for_each_set(
+                            m, [&](size_t k) { ret.push_back({r, c + static_cast<int>(k)}); });
+                    }
+                }
+                for (; c < grid.cols(); ++c) {
+                    if (grid(r, c) == GridState::ROLL
+                        && grid.count_neighbors(r, c, GridState::ROLL) < 4) {
+                        ret.push_back({r, c});
+                    }
+                }
+            }
+        },
+        grid, ret);
 }
 
-auto removable(const G &grid) {
-    return grid.elts() | rv::filter([](const auto &elt) { return elt.ref == GridState::ROLL; })
-           | rv::transform(
-               [grid](const auto &p) { return std::make_pair(p, fullNeighbors(grid, p)); })
-           | rv::filter([](const auto &pp) {
-                 const auto &[p, count] = pp;
-                 return count <= 4;
-             })
-           | rv::transform([](const auto &pp) {
-                 auto [p, count] = pp;
-                 return p;
-             });
+G parse(std::string_view input, std::pmr::memory_resource *mr) {
+    return G::from_lines(prelude::lines(input), fromChar, 1, GridState::EMPTY, mr);
 }
 
-int main(int, char **) {
-    fmt::print("hello world\n");
-    Grid<GridState> grid(prelude::line_view(std::cin) | rv::transform([](const auto &line) {
-                             return line | rv::transform(fromChar) | prelude::collect<std::vector>;
-                         })
-                         | prelude::collect<std::vector>);
+long part1(const G &grid) {
+    std::vector<Coord> r;
+    removable(grid, r);
+    return r.size();
+}
 
-    int part1 = 0;
-    int part2 = 0;
+long part2(G grid) {
+    long removed = 0;
+    // one buffer for every round rather than a fresh vector each time
+    std::vector<Coord> r;
     while (true) {
-        auto r = removable(grid) | prelude::collect<std::vector>;
+        removable(grid, r);
         if (r.size() == 0) {
             break;
         }
-        if (part1 == 0) {
-            part1 = r.size();
-        }
-        part2 += r.size();
+        removed += r.size();
         for (auto &p : r) {
             grid.set(p.row, p.col, GridState::EMPTY);
         }
     }
+    return removed;
+}
 
-    fmt::print("part 1: {}\n", part1);
-    fmt::print("part 2: {}\n", part2);
+} // namespace
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2025, 4, parse, part1, part2);
@@ -0,0 +1,20 @@
+#include "prelude/gen.hpp"
+
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long rows = args.get("rows", 140l, "grid height");
+    const long cols = args.get("cols", 140l, "grid width");
+    const double density = args.get("density", 0.6, "chance of each cell holding a roll");
+    prelude::rng rng(args.seed());
+    args.done();
+
+    for (long r = 0; r < rows; ++r) {
+        for (long c = 0; c < cols; ++c) {
+            out.put(rng.chance(density) ? '@' : '.');
+        }
+        out.put('\n');
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 4: a grid of paper rolls.", generate);
+}
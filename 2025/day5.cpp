@@ -1,64 +1,98 @@
+#include "prelude/aoc.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
+#include "prelude/simd.hpp"
+#include "prelude/soa.hpp"
 
-bool is_blank(const std::string &line) {
-    return line.empty() || std::ranges::all_of(line, isspace);
-}
+namespace {
 
-struct Range {
-    // inclusive! And we're trusting the input to be ordered.
-    long begin, end;
+bool is_blank(std::string_view line) { return prelude::chomp(line).empty(); }
 
-    static Range fromString(const std::string &s) {
-        auto parts = s | std::views::split('-');
-        auto it = parts.begin();
-        long b = std::stol(std::string((*it).begin(), (*it).end()));
-        ++it;
-        long e = std::stol(std::string((*it).begin(), (*it).end()));
-        return Range{b, e};
-    }
+// Fresh ranges, inclusive!
+enum { BEGIN, END };
+using Ranges = prelude::soa_vector<long, long>;
 
-    bool contains(const long x) const { return x >= begin && x <= end; }
-    bool overlaps(const Range &o) const { return end >= o.begin && begin <= o.end; }
-    long size() const { return 1 + end - begin; }
-    Range combine(const Range &o) const {
-        return Range{std::min(begin, o.begin), std::max(end, o.end)};
-    }
+struct Inventory {
+    Ranges ranges;
+    std::vector<long> ids;
 };
 
-int main(int, char **) {
-    auto lines = prelude::line_view(std::cin);
-    auto ranges = lines
-                  | std::views::take_while([](const std::string &line) { return !is_blank(line); })
-                  | rv::transform(Range::fromString) | prelude::collect<std::vector>;
-    auto num_lines
-        = lines | std::views::drop_while([](const std::string &line) { return is_blank(line); })
-          | rv::transform([](const std::string &s) { return std::stol(s); })
-          | prelude::collect<std::vector>;
+// fresh ranges, a blank line, then ingredient ids
+Inventory parse(std::string_view input) {
+    Inventory inv;
+    bool in_ranges = true;
+    for (auto line : prelude::lines(input)) {
+        if (is_blank(line)) {
+            in_ranges = false;
+        } else if (in_ranges) {
+            auto [b, e] = prelude::ints<2>(line);
+            inv.ranges.emplace_back(b, e);
+        } else {
+            inv.ids.push_back(prelude::ints<1>(line)[0]);
+        }
+    }
+    return inv;
+}
 
-    auto part1 = std::ranges::distance(num_lines | rv::filter([ranges](const long x) {
-                                           for (auto &r : ranges) {
-                                               if (r.contains(x)) {
-                                                   return true;
-                                               }
-                                           }
-                                           return false;
-                                       }));
-    fmt::print("part 1: {}\n", part1);
+void save(const Inventory &inv, prelude::column_writer &out) {
+    out.soa(inv.ranges);
+    out.column(inv.ids);
+}
 
-    std::sort(ranges.begin(), ranges.end(),
-              [](const auto &a, const auto &b) { return a.begin < b.begin; });
+Inventory load(prelude::column_reader &in) {
+    auto ranges = in.soa<long, long>();
+    auto ids = in.column<long>();
+    return {std::move(ranges), std::vector<long>(ids.begin(), ids.end())};
+}
 
-    std::vector<Range> merged;
-    for (auto const &r : ranges) {
-        if (merged.empty() || !merged.back().overlaps(r)) {
-            merged.push_back(r);
-        } else {
-            merged.back() = merged.back().combine(r);
+long part1(const Inventory &inv) {
+    // every id against every range, with no early exit so it's all vector compares
+    auto count_fresh = []<size_t W>(std::span<const long> begins, std::span<const long> ends,
+                                    std::span<const long> ids) {
+        long n = 0;
+        for (const long id : ids) {
+            size_t i = 0;
+            bool fresh = false;
+            if constexpr (W > 0) {
+                using V = prelude::simd::vec<long, W>;
+                typename V::mask_type in{};
+                for (; i + V::size <= begins.size(); i += V::size) {
+                    in |= (V::load(&begins[i]) <= id) & (V::load(&ends[i]) >= id);
+                }
+                fresh = prelude::simd::any(in);
+            }
+            for (; i < begins.size(); ++i) {
+                fresh |= begins[i] <= id && id <= ends[i];
+            }
+            n += fresh;
         }
+        return n;
+    };
+    return prelude::simd::dispatch(count_fresh, inv.ranges.field<BEGIN>(),
+                                   inv.ranges.field<END>(), std::span<const long>(inv.ids));
+}
+
+long part2(Inventory inv) {
+    // Pairing the i-th smallest begin with the i-th smallest end makes
+    // different ranges that cover every id just as many times, so the union
+    // is the same, and each field can be sorted on its own.
+    auto begins = inv.ranges.field<BEGIN>(), ends = inv.ranges.field<END>();
+    std::sort(begins.begin(), begins.end());
+    std::sort(ends.begin(), ends.end());
+
+    long total = 0;
+    for (size_t i = 0; i < begins.size();) {
+        const long begin = begins[i];
+        long end = ends[i];
+        for (++i; i < begins.size() && begins[i] <= end; ++i) {
+            end = ends[i];
+        }
+        total += 1 + end - begin;
     }
+    return total;
+}
 
-    auto part2 = merged | rv::transform([](const auto &r) { return r.size(); }) | prelude::sum;
-    fmt::print("part 2: {}\n", part2);
+} // namespace
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2025, 5, parse, part1, part2);
+AOC_SOLUTION_COLUMNS(2025, 5, save, load);
@@ -0,0 +1,26 @@
+#include "prelude/gen.hpp"
+
+// Ranges are independent, so plenty of them overlap, which is the point of
+// part 2.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long ranges = args.get("ranges", 180l, "number of fresh ranges");
+    const long ids = args.get("ids", 1000l, "number of ids to check");
+    const long max = args.get("max", 500000000000000l, "ids are in [1, max]");
+    const long width = args.get("width", 10000000000000l, "ranges cover at most this many ids");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(max >= 1 && width >= 1, "max and width must be at least 1");
+
+    for (long i = 0; i < ranges; ++i) {
+        const long lo = rng.uniform(1l, max);
+        out.print("{}-{}\n", lo, std::min(max, lo + rng.uniform(0l, width - 1)));
+    }
+    out.put('\n');
+    for (long i = 0; i < ids; ++i) {
+        out.print("{}\n", rng.uniform(1l, max));
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 5: fresh id ranges, then ids.", generate);
+}
@@ -1,8 +1,13 @@
+#include "prelude/aoc.hpp"
+#include "prelude/arena.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
 
+namespace {
+
 enum Operand { SUM, PRODUCT, NONE };
 
-Operand operandFromString(const std::string &s) {
+Operand operandFromString(std::string_view s) {
     if (s == "+") {
         return Operand::SUM;
     } else if (s == "*") {
@@ -23,20 +28,26 @@ template <typename R> long compute(Operand o, R &&r) {
     }
 }
 
-long part1(const std::vector<std::string> &raw_input) {
-    std::vector<std::vector<std::string>> orig_input = raw_input | rv::transform(prelude::chomp)
-                                                       | rv::transform(prelude::split_ws)
-                                                       | prelude::collect<std::vector>;
+long part1(const std::vector<std::string_view> &raw_input) {
+    // a row of tokens per line and a column of numbers per problem, all
+    // scratch: take them from one arena and drop it in one go
+    prelude::arena arena;
+    auto row = [&](std::string_view line) {
+        return prelude::tokens(line) | prelude::collect<prelude::pmr::vector>(arena);
+    };
+    auto orig_input
+        = raw_input | rv::transform(row) | prelude::collect<prelude::pmr::vector>(arena);
 
     auto operands
         = orig_input.back() | rv::transform(operandFromString) | prelude::collect<std::vector>;
     orig_input.pop_back();
 
-    std::vector<std::vector<long>> nums;
+    prelude::pmr::vector<prelude::pmr::vector<long>> nums(arena.resource());
     nums.resize(orig_input[0].size());
     for (size_t i = 0; i < orig_input[0].size(); ++i) {
+        nums[i].reserve(orig_input.size());
         for (size_t j = 0; j < orig_input.size(); ++j) {
-            nums[i].push_back(std::stol(orig_input[j][i]));
+            nums[i].push_back(prelude::ints<1>(orig_input[j][i])[0]);
         }
     }
 
@@ -49,9 +60,11 @@ long part1(const std::vector<std::string> &raw_input) {
     return part1;
 }
 
-long part2(std::vector<std::string> &orig) {
-    auto operands = prelude::split_ws(prelude::chomp(orig.back()))
-                    | rv::transform(operandFromString) | prelude::collect<std::vector>;
+long part2(const std::vector<std::string_view> &raw_input) {
+    // transpose builds new strings, so it wants owned ones to start from
+    std::vector<std::string> orig(raw_input.begin(), raw_input.end());
+    auto operands = prelude::tokens(orig.back()) | rv::transform(operandFromString)
+                    | prelude::collect<std::vector>;
     orig.pop_back();
 
     auto reformed = prelude::transpose(orig) | rv::transform(prelude::chomp);
@@ -64,7 +77,7 @@ long part2(std::vector<std::string> &orig) {
             part2 += compute(operands[op++], accum);
             accum.clear();
         } else {
-            accum.push_back(std::stol(s));
+            accum.push_back(prelude::ints<1>(s)[0]);
         }
     }
     part2 += compute(operands[op++], accum);
@@ -72,11 +85,10 @@ long part2(std::vector<std::string> &orig) {
     return part2;
 }
 
-int main(int, char **) {
-    std::vector<std::string> raw_input
-        = prelude::line_view(std::cin) | prelude::collect<std::vector>;
+std::vector<std::string_view> parse(std::string_view input) {
+    return prelude::lines(input) | prelude::collect<std::vector>;
+}
+
+} // namespace
 
-    fmt::print("part 1: {}\n", part1(raw_input));
-    fmt::print("part 2: {}\n", part2(raw_input));
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2025, 6, parse, part1, part2);
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include <string>
+#include <vector>
+
+#include "prelude/gen.hpp"
+
+// Each problem is as wide as its longest number, with the shorter ones pushed
+// to the left or right at random (which is what part 2's column reading is
+// about), and one blank column between problems.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long problems = args.get("problems", 1000l, "number of problems");
+    const int rows = args.get("rows", 4, "numbers per problem");
+    const int digits = args.get("digits", 3, "numbers have up to this many digits");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(rows >= 1 && digits >= 1, "rows and digits must be at least 1");
+    // every product has to fit in a long, with room to add them up
+    args.check(rows * digits <= 15, "rows * digits must be at most 15");
+
+    std::vector<std::string> lines(rows + 1);
+    std::vector<std::string> nums(rows);
+    for (long p = 0; p < problems; ++p) {
+        size_t width = 0;
+        for (auto &n : nums) {
+            const int d = rng.uniform(1, digits);
+            n.assign(1, static_cast<char>('0' + rng.uniform(1, 9)));
+            for (int i = 1; i < d; ++i) {
+                n.push_back(static_cast<char>('0' + rng.uniform(0, 9)));
+            }
+            width = std::max(width, n.size());
+        }
+
+        for (int r = 0; r < rows; ++r) {
+            const std::string pad(width - nums[r].size(), ' ');
+            lines[r] += (p == 0 ? "" : " ") + (rng.chance(0.5) ? pad + nums[r] : nums[r] + pad);
+        }
+        lines[rows] += (p == 0 ? "" : " ") + std::string(1, rng.chance(0.5) ? '+' : '*')
+                       + std::string(width - 1, ' ');
+    }
+
+    for (const auto &line : lines) {
+        out.print("{}\n", line);
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 6: a worksheet of math problems.", generate);
+}
@@ -1,64 +1,99 @@
+#include "prelude/aoc.hpp"
+#include "prelude/grid.hpp"
+#include "prelude/input.hpp"
 #include "prelude/prelude.hpp"
+#include "prelude/simd.hpp"
 
-long calc_part1(std::vector<std::string> &lines) {
-    long count = 0;
-    for (size_t i = 1; i < lines.size(); ++i) {
-        std::string &line = lines[i];
-        for (size_t c = 0; c < line.size(); ++c) {
-            if (line[c] == '.') {
-                if ((c > 0 && line[c - 1] == '^') || ((c + 1) < line.size() && line[c + 1] == '^')
-                    || lines[i - 1][c] == 'S' || lines[i - 1][c] == '|') {
-                    line[c] = '|';
+namespace {
+
+using G = prelude::Grid<char>;
+
+// Marks every cell a beam passes through with '|', returning the number of
+// splitters it hits. The grid's one-cell '.' halo covers the edges.
+//
+// A row only depends on the row above and on the splitters beside each cell,
+// which never change, so a whole run of a row is done at once.
+long calc_part1(G &grid) {
+    return prelude::simd::dispatch(
+        []<size_t W>(G &grid) {
+            long count = 0;
+            for (int r = 1; r < grid.rows(); ++r) {
+                const char *up = &grid(r - 1, 0);
+                char *row = &grid(r, 0);
+                int c = 0;
+                if constexpr (W > 0) {
+                    using V = prelude::simd::vec<char, W>;
+                    for (; c + static_cast<int>(W) <= grid.cols(); c += W) {
+                        const V above = V::load(up + c), cell = V::load(row + c);
+                        const auto beam = (V::load(row + c - 1) == '^')
+                                          | (V::load(row + c + 1) == '^') | (above == 'S')
+                                          | (above == '|');
+                        prelude::simd::select((cell == '.') & beam, V::splat('|'), cell)
+                            .store(row + c);
+                        count += prelude::simd::count((cell == '^') & (above == '|'));
+                    }
                 }
-            } else if (line[c] == '^') {
-                if (lines[i - 1][c] == '|') {
-                    ++count;
+                for (; c < grid.cols(); ++c) {
+                    const char above = up[c];
+                    char &cell = row[c];
+                    if (cell == '.') {
+                        if (row[c - 1] == '^' || row[c + 1] == '^' || above == 'S'
+                            || above == '|') {
+                            cell = '|';
+                        }
+                    } else if (cell == '^') {
+                        if (above == '|') {
+                            ++count;
+                        }
+                    }
                 }
             }
-        }
-    }
-
-    return count;
+            return count;
+        },
+        grid);
 }
 
-long calc_part2(std::vector<std::string> &lines) {
-    std::reverse(lines.begin(), lines.end());
-
-    std::vector<std::vector<long>> counts;
-    counts.push_back(lines.front()
-                     | rv::transform([](const char ch) { return ch == '|' ? 1l : 0l; })
-                     | prelude::collect<std::vector>);
+// Counts timelines bottom-up over a grid already marked by calc_part1.
+long calc_part2(const G &grid) {
+    // one padding column on each side, so i - 1 and i + 1 are always valid
+    std::vector<long> below(grid.cols() + 2), current(grid.cols() + 2);
+    for (int c = 0; c < grid.cols(); ++c) {
+        below[c + 1] = grid(grid.rows() - 1, c) == '|' ? 1l : 0l;
+    }
 
-    for (auto &line : lines | rv::drop(1)) {
-        auto &pc = counts.back();
-        std::vector<long> next;
-        for (size_t i = 0; i < line.size(); ++i) {
-            switch (line[i]) {
+    for (int r = grid.rows() - 2; r >= 0; --r) {
+        for (int c = 0; c < grid.cols(); ++c) {
+            const size_t i = c + 1;
+            switch (grid(r, c)) {
             case 'S':
             case '|':
-                next.push_back(pc[i]);
+                current[i] = below[i];
                 break;
             case '^':
-                next.push_back(pc[i - 1] + pc[i + 1]);
+                current[i] = below[i - 1] + below[i + 1];
                 break;
             default:
-                next.push_back(0l);
+                current[i] = 0l;
                 break;
             }
         }
-        counts.push_back(std::move(next));
+        std::swap(below, current);
     }
 
-    return counts.back() | prelude::sum;
+    return below | prelude::sum;
+}
+
+G parse(std::string_view input) {
+    return G::from_lines(prelude::lines(input), [](const char ch) { return ch; }, 1, '.');
 }
 
-int main(int, char **) {
-    auto lines = prelude::line_view(std::cin) | prelude::collect<std::vector>;
+long part1(G grid) { return calc_part1(grid); }
+
+long part2(G grid) {
+    calc_part1(grid);
+    return calc_part2(grid);
+}
 
-    long part1 = calc_part1(lines);
-    long part2 = calc_part2(lines);
+} // namespace
 
-    fmt::print("part 1: {}\n", part1);
-    fmt::print("part 2: {}\n", part2);
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2025, 7, parse, part1, part2);
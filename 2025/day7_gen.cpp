@@ -0,0 +1,32 @@
+#include "prelude/gen.hpp"
+
+// Splitters go on every other row, never side by side. Part 2's timeline
+// count grows by roughly (1 + density) per splitter row, so very tall
+// manifolds at high density overflow it.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long rows = args.get("rows", 142l, "manifold height");
+    const long cols = args.get("cols", 141l, "manifold width");
+    const double density = args.get("density", 0.5, "chance of a splitter at each spot");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(rows >= 1 && cols >= 3, "the manifold must be at least 1x3");
+
+    for (long r = 0; r < rows; ++r) {
+        bool last = false;
+        for (long c = 0; c < cols; ++c) {
+            char ch = '.';
+            if (r == 0) {
+                ch = c == cols / 2 ? 'S' : '.';
+            } else if (r % 2 == 0 && c > 0 && c + 1 < cols && !last && rng.chance(density)) {
+                ch = '^';
+            }
+            last = ch == '^';
+            out.put(ch);
+        }
+        out.put('\n');
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 7: a tachyon manifold.", generate);
+}
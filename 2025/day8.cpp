@@ -1,26 +1,28 @@
-#include <set>
-
+#include "prelude/aoc.hpp"
+#include "prelude/hash.hpp"
+#include "prelude/input.hpp"
+#include "prelude/parallel.hpp"
 #include "prelude/prelude.hpp"
+#include "prelude/simd.hpp"
+#include "prelude/soa.hpp"
+#include "prelude/sort.hpp"
 
-struct vec3 {
-    long x, y, z;
-};
+namespace {
 
-std::ostream &operator<<(std::ostream &out, vec3 &v) {
-    out << "<" << v.x << ", " << v.y << ", " << v.z << ">";
-    return out;
-}
+enum axis { X, Y, Z };
+using Points = prelude::soa_vector<long, long, long>;
 
-long distance(const vec3 &a, const vec3 &b) {
-    long dx = a.x - b.x;
-    long dy = a.y - b.y;
-    long dz = a.z - b.z;
+long distance(const Points &points, size_t a, size_t b) {
+    auto [ax, ay, az] = points[a];
+    auto [bx, by, bz] = points[b];
+    long dx = ax - bx;
+    long dy = ay - by;
+    long dz = az - bz;
     return dx * dx + dy * dy + dz * dz;
 }
 
 struct edge {
     size_t a, b;
-    long distance;
 };
 
 struct DSU {
@@ -58,7 +60,7 @@ struct DSU {
     }
 
     auto subgraph_sizes() {
-        std::map<size_t, size_t> sizes;
+        prelude::flat_map<size_t, size_t> sizes;
         for (size_t i = 0; i < parent.size(); ++i) {
             auto root = find(i);
             sizes[root] = size[root];
@@ -84,65 +86,228 @@ struct DSU {
     }
 
     size_t connections() const {
-        std::set<size_t> ps(parent.begin(), parent.end());
+        prelude::flat_set<size_t> ps(parent.begin(), parent.end());
         return ps.size();
     }
 };
 
-long calc_part1(const std::vector<vec3> &verts, const std::vector<edge> &es) {
-    DSU dsu(verts.size());
-    const size_t N = verts.size() < 100 ? 10 : 1000;
-    for (auto &e : es | rv::take(N)) {
-        dsu.unite(e.a, e.b);
+// An edge that doesn't pack into 64 bits, for more points than key_packer
+// has room for (over 16384, with coordinates up to 100000).
+struct wide_edge {
+    uint64_t distance;
+    uint32_t a, b;
+};
+
+struct Network {
+    Points points;
+    // Every pair of points, shortest first. Packed as (distance, a, b) where
+    // that fits, so the sort moves 8 bytes an edge, or wide where it doesn't.
+    std::vector<uint64_t> edges;
+    std::vector<wide_edge> wide;
+    std::optional<prelude::key_packer> pack; // empty if the edges are wide
+    int index_bits = 0;
+
+    size_t edge_count() const { return pack ? edges.size() : wide.size(); }
+
+    edge at(size_t i) const {
+        if (!pack) {
+            return {wide[i].a, wide[i].b};
+        }
+        const uint64_t ab = pack->payload(edges[i]);
+        return {ab >> index_bits, ab & ((uint64_t{1} << index_bits) - 1)};
+    }
+
+    auto sorted_edges() const {
+        return rv::iota(size_t{0}, edge_count())
+               | rv::transform([this](size_t i) { return at(i); });
+    }
+};
+
+long part1(const Network &net) {
+    DSU dsu(net.points.size());
+    const size_t N = net.points.size() < 100 ? 10 : 1000;
+    for (auto [a, b] : net.sorted_edges() | rv::take(N)) {
+        dsu.unite(a, b);
     }
     auto subsizes = dsu.subgraph_sizes();
 
     return subsizes | rv::take(3) | prelude::product;
 }
 
-long calc_part2(const std::vector<vec3> &verts, const std::vector<edge> &es) {
-    DSU dsu(verts.size());
-    for (auto &e : es) {
-        dsu.unite(e.a, e.b);
+long part2(const Network &net) {
+    DSU dsu(net.points.size());
+    for (auto [a, b] : net.sorted_edges()) {
+        dsu.unite(a, b);
         if (dsu.fully_connected()) {
-            long ret = verts[e.a].x * verts[e.b].x;
-            return ret;
+            auto xs = net.points.field<X>();
+            return xs[a] * xs[b];
         }
     }
     return -1;
 }
 
-int main(int, char **) {
-    auto points = prelude::line_view(std::cin) | rv::transform([](const std::string &line) {
-                      auto parts = line | rv::split(',') | rv::transform([](auto &&r) {
-                                       return std::stol(std::string(r.begin(), r.end()));
-                                   });
-                      vec3 v;
-                      auto ints = parts.begin();
-                      v.x = *ints++;
-                      v.y = *ints++;
-                      v.z = *ints++;
-                      return v;
-                  })
-                  | prelude::collect<std::vector>;
-
-    std::vector<edge> edges;
-    edges.reserve(points.size() * points.size());
-
-    for (size_t a = 0; a < points.size(); ++a) {
-        for (size_t b = 1 + a; b < points.size(); ++b) {
-            edges.emplace_back(a, b, distance(points[a], points[b]));
+// The largest squared distance between any two points could be.
+uint64_t distance_bound(const Points &points) {
+    if (points.size() == 0) {
+        return 0;
+    }
+    auto span = [](std::span<const long> axis) {
+        auto [lo, hi] = std::ranges::minmax(axis);
+        return static_cast<uint64_t>((hi - lo) * (hi - lo));
+    };
+    return span(points.field<X>()) + span(points.field<Y>()) + span(points.field<Z>());
+}
+
+// Everything but the edges.
+Network network(Points points) {
+    Network net;
+    net.points = std::move(points);
+    const size_t n = net.points.size();
+    if (n == 0) {
+        return net;
+    }
+    const int bits = std::bit_width(n - 1);
+    const uint64_t last = n - 1;
+    const uint64_t bound = distance_bound(net.points);
+    if (bits < 32 && prelude::key_packer::fits(bound, last << bits | last)) {
+        net.pack.emplace(bound, last << bits | last);
+        net.index_bits = bits;
+    }
+    return net;
+}
+
+// Both parts walk the same sorted edge list, so building it is part of
+// parsing.
+Network parse(std::string_view input) {
+    Network net = network(Points(prelude::par_lines(input, [](std::string_view line) {
+        return prelude::ints<3>(line);
+    })));
+    const size_t n = net.points.size();
+    if (n == 0) {
+        return net;
+    }
+
+    {
+        prelude::scoped_timer t("edges");
+        if (net.pack) {
+            net.edges.reserve(n * (n - 1) / 2);
+        } else {
+            net.wide.reserve(n * (n - 1) / 2);
         }
+
+        // each axis is its own array, so a run of points is one vector load each
+        prelude::simd::dispatch(
+            []<size_t W>(Network &net) {
+                const auto &points = net.points;
+                const size_t n = points.size();
+                const auto xs = points.field<X>(), ys = points.field<Y>(), zs = points.field<Z>();
+                std::vector<long> d(n);
+                for (size_t a = 0; a < n; ++a) {
+                    size_t b = a + 1;
+                    if constexpr (W > 0) {
+                        using V = prelude::simd::vec<long, W>;
+                        const V x = V::splat(xs[a]), y = V::splat(ys[a]), z = V::splat(zs[a]);
+                        for (; b + V::size <= n; b += V::size) {
+                            const V dx = V::load(&xs[b]) - x, dy = V::load(&ys[b]) - y,
+                                    dz = V::load(&zs[b]) - z;
+                            (dx * dx + dy * dy + dz * dz).store(&d[b]);
+                        }
+                    }
+                    for (; b < n; ++b) {
+                        d[b] = distance(points, a, b);
+                    }
+                    if (net.pack) {
+                        for (b = a + 1; b < n; ++b) {
+                            net.edges.push_back((*net.pack)(d[b], a << net.index_bits | b));
+                        }
+                    } else {
+                        for (b = a + 1; b < n; ++b) {
+                            net.wide.push_back({static_cast<uint64_t>(d[b]),
+                                                static_cast<uint32_t>(a),
+                                                static_cast<uint32_t>(b)});
+                        }
+                    }
+                }
+            },
+            net);
+    }
+
+    prelude::scoped_timer t("sort");
+    if (net.pack) {
+        prelude::radix_sort(net.edges);
+    } else {
+        prelude::radix_sort(net.wide, &wide_edge::distance);
     }
+    return net;
+}
 
-    std::sort(edges.begin(), edges.end(),
-              [](const edge &a, const edge &b) { return a.distance < b.distance; });
+// The sorted edges too, so loading skips the O(n^2) part as well. Wide edges
+// go as a column each of distances, as and bs.
+void save(const Network &net, prelude::column_writer &out) {
+    out.soa(net.points);
+    if (net.pack) {
+        out.column(net.edges);
+        return;
+    }
+    out.column(net.wide | rv::transform(&wide_edge::distance) | prelude::collect<std::vector>);
+    out.column(net.wide | rv::transform(&wide_edge::a) | prelude::collect<std::vector>);
+    out.column(net.wide | rv::transform(&wide_edge::b) | prelude::collect<std::vector>);
+}
 
-    auto part1 = calc_part1(points, edges);
-    auto part2 = calc_part2(points, edges);
+// The parts index points by the edges without looking, so a file that didn't
+// come from save() has to have every pair once, lower index first and
+// shortest edge first, like parse gives, and nothing else. Whether the
+// distances are right isn't checked; they'd only make the answers wrong.
+void check_edges(const Network &net) {
+    auto fail = [](const std::string &why) {
+        throw std::runtime_error("columnar input: " + why);
+    };
+    const size_t n = net.points.size();
+    if (net.edge_count() != n * (n - 1) / 2) {
+        fail(fmt::format("{} edges for {} points, not {}", net.edge_count(), n, n * (n - 1) / 2));
+    }
+    std::vector<bool> seen(net.edge_count());
+    for (size_t i = 0; i < net.edge_count(); ++i) {
+        const auto [a, b] = net.at(i);
+        if (a >= b || b >= n) {
+            fail(fmt::format("edge {} joins points {} and {}, of {}", i, a, b, n));
+        }
+        // pairs (0, 1)..(0, n-1) come first, then (1, 2).., and so on
+        const size_t pair = a * n - a * (a + 1) / 2 + (b - a - 1);
+        if (seen[pair]) {
+            fail(fmt::format("edge {} joins points {} and {} again", i, a, b));
+        }
+        seen[pair] = true;
+        if (i > 0
+            && (net.pack ? net.edges[i] < net.edges[i - 1]
+                         : net.wide[i].distance < net.wide[i - 1].distance)) {
+            fail(fmt::format("edge {} is shorter than the one before", i));
+        }
+    }
+}
+
+Network load(prelude::column_reader &in) {
+    Network net = network(in.soa<long, long, long>());
+    if (net.pack) {
+        auto edges = in.column<uint64_t>();
+        net.edges.assign(edges.begin(), edges.end());
+    } else {
+        auto distances = in.column<uint64_t>();
+        auto as = in.column<uint32_t>();
+        auto bs = in.column<uint32_t>();
+        if (as.size() != distances.size() || bs.size() != distances.size()) {
+            throw std::runtime_error("columnar input: edge columns of different lengths");
+        }
+        net.wide.reserve(distances.size());
+        for (size_t i = 0; i < distances.size(); ++i) {
+            net.wide.push_back({distances[i], as[i], bs[i]});
+        }
+    }
+    check_edges(net);
+    return net;
+}
 
-    fmt::print("part 1 = {}\n", part1);
-    fmt::print("part 2 = {}\n", part2);
+} // namespace
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2025, 8, parse, part1, part2);
+AOC_SOLUTION_COLUMNS(2025, 8, save, load);
\ No newline at end of file
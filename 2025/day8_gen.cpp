@@ -0,0 +1,20 @@
+#include "prelude/gen.hpp"
+
+// Parsing builds and sorts all n^2 / 2 edges, so memory goes quadratic fast:
+// n = 20000 is already ~200M edges.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 1000l, "number of junction boxes");
+    const long max = args.get("max", 100000l, "coordinates are in [0, max)");
+    prelude::rng rng(args.seed());
+    args.done();
+    args.check(n >= 2 && max >= 1, "need at least 2 boxes and max >= 1");
+
+    for (long i = 0; i < n; ++i) {
+        out.print("{},{},{}\n", rng.uniform(0l, max - 1), rng.uniform(0l, max - 1),
+                  rng.uniform(0l, max - 1));
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 8: n junction boxes in a cube.", generate);
+}
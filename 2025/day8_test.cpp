@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "prelude/aoc.hpp"
+#include "prelude/columnar.hpp"
+#include "prelude/soa.hpp"
+#include "prelude/sort.hpp"
+
+namespace {
+
+const prelude::solution &day8() {
+    for (const auto &s : prelude::registry()) {
+        if (s.year == 2025 && s.day == 8) {
+            return s;
+        }
+    }
+    throw std::logic_error("2025 day 8 isn't registered");
+}
+
+using Points = prelude::soa_vector<long, long, long>;
+
+Points points(std::vector<long> xs) {
+    Points p;
+    for (long x : xs) {
+        p.emplace_back(x, 0, 0);
+    }
+    return p;
+}
+
+// What save() writes for three points small enough that the edges pack as
+// (distance, a << 2 | b).
+std::string packed(const std::vector<std::pair<uint64_t, uint64_t>> &edges) {
+    const prelude::key_packer pack(9, 2 << 2 | 2);
+    std::vector<uint64_t> words;
+    for (auto [distance, ab] : edges) {
+        words.push_back(pack(distance, ab));
+    }
+    prelude::column_writer out;
+    out.soa(points({0, 1, 3}));
+    out.column(words);
+    return out.bytes(2025, 8, day8().version);
+}
+
+struct wide_edge {
+    uint64_t distance;
+    uint32_t a, b;
+};
+
+// And for three far enough apart that they don't.
+std::string wide(const std::vector<wide_edge> &edges) {
+    std::vector<uint64_t> distances;
+    std::vector<uint32_t> as, bs;
+    for (auto [distance, a, b] : edges) {
+        distances.push_back(distance);
+        as.push_back(a);
+        bs.push_back(b);
+    }
+    prelude::column_writer out;
+    out.soa(points({0, 1L << 30, 3}));
+    out.column(distances);
+    out.column(as);
+    out.column(bs);
+    return out.bytes(2025, 8, day8().version);
+}
+
+} // namespace
+
+TEST(Day8Test, TestPackedColumns) {
+    const auto &s = day8();
+    const auto text = prelude::solve(s, "0,0,0\n1,0,0\n3,0,0\n");
+    const auto loaded
+        = prelude::solve(s, packed({{1, 0 << 2 | 1}, {4, 1 << 2 | 2}, {9, 0 << 2 | 2}}));
+    EXPECT_EQ(loaded.part1, text.part1);
+    EXPECT_EQ(loaded.part2, text.part2);
+
+    // a point that isn't there, a point joined to itself, an edge missing,
+    // the edges out of order, and one pair twice in place of another
+    EXPECT_THROW(prelude::solve(s, packed({{1, 0 << 2 | 1}, {4, 1 << 2 | 2}, {9, 0 << 2 | 3}})),
+                 std::runtime_error);
+    EXPECT_THROW(prelude::solve(s, packed({{1, 0 << 2 | 1}, {4, 1 << 2 | 2}, {9, 2 << 2 | 2}})),
+                 std::runtime_error);
+    EXPECT_THROW(prelude::solve(s, packed({{1, 0 << 2 | 1}, {4, 1 << 2 | 2}})),
+                 std::runtime_error);
+    EXPECT_THROW(prelude::solve(s, packed({{4, 1 << 2 | 2}, {1, 0 << 2 | 1}, {9, 0 << 2 | 2}})),
+                 std::runtime_error);
+    EXPECT_THROW(prelude::solve(s, packed({{1, 0 << 2 | 1}, {4, 0 << 2 | 1}, {9, 0 << 2 | 2}})),
+                 std::runtime_error);
+}
+
+TEST(Day8Test, TestWideColumns) {
+    const auto &s = day8();
+    const uint64_t far = uint64_t{1} << 60, near = ((1L << 30) - 3) * ((1L << 30) - 3);
+    const auto text = prelude::solve(s, "0,0,0\n1073741824,0,0\n3,0,0\n");
+    const auto loaded = prelude::solve(s, wide({{9, 0, 2}, {near, 1, 2}, {far, 0, 1}}));
+    EXPECT_EQ(loaded.part1, text.part1);
+    EXPECT_EQ(loaded.part2, text.part2);
+
+    EXPECT_THROW(prelude::solve(s, wide({{9, 0, 2}, {near, 1, 2}, {far, 0, 4000000000}})),
+                 std::runtime_error);
+    EXPECT_THROW(prelude::solve(s, wide({{9, 0, 2}, {near, 1, 1}, {far, 0, 1}})),
+                 std::runtime_error);
+    EXPECT_THROW(prelude::solve(s, wide({{near, 1, 2}, {9, 0, 2}, {far, 0, 1}})),
+                 std::runtime_error);
+    EXPECT_THROW(prelude::solve(s, wide({{9, 0, 2}, {near, 0, 2}, {far, 0, 1}})),
+                 std::runtime_error);
+}
@@ -1,11 +1,20 @@
 
+#include "prelude/aoc.hpp"
+#include "prelude/input.hpp"
+#include "prelude/parallel.hpp"
 #include "prelude/prelude.hpp"
+#include "prelude/simd.hpp"
+#include "prelude/soa.hpp"
+
+namespace {
 
 struct Point {
     double x, y;
     auto operator<=>(const Point &) const = default;
 };
 
+} // namespace
+
 template <> struct fmt::formatter<Point> : fmt::formatter<std::string_view> {
     auto format(const Point &p, fmt::format_context &ctx) const {
         std::string s = fmt::format("({}, {})", p.x, p.y);
@@ -13,24 +22,52 @@ template <> struct fmt::formatter<Point> : fmt::formatter<std::string_view> {
     }
 };
 
+namespace {
+
+// Red tiles, in order around the loop.
+enum { X, Y };
+using Corners = prelude::soa_vector<double, double>;
+
 long size(const Point &a, const Point &b) {
     return (1l + std::abs(a.x - b.x)) * (1 + std::abs(a.y - b.y));
 }
 
-long calc_part1(const std::vector<Point> &points) {
-    long part1 = 0;
-    for (auto a : points) {
-        for (auto b : points) {
-            part1 = std::max(part1, size(a, b));
+long calc_part1(const Corners &corners) {
+    auto largest = []<size_t W>(std::span<const double> xs, std::span<const double> ys) {
+        const size_t n = xs.size();
+        double best = 0;
+        for (size_t a = 0; a < n; ++a) {
+            size_t b = a;
+            if constexpr (W > 0) {
+                using V = prelude::simd::vec<double, W>;
+                const V ax = V::splat(xs[a]), ay = V::splat(ys[a]), zero = V::splat(0);
+                V most = zero;
+                for (; b + V::size <= n; b += V::size) {
+                    const V dx = V::load(&xs[b]) - ax, dy = V::load(&ys[b]) - ay;
+                    const V w = select(dx < 0, zero - dx, dx) + 1;
+                    const V h = select(dy < 0, zero - dy, dy) + 1;
+                    most = select(w * h > most, w * h, most);
+                }
+                for (size_t i = 0; i < V::size; ++i) {
+                    best = std::max(best, most[i]);
+                }
+            }
+            for (; b < n; ++b) {
+                const double w = 1 + std::abs(xs[a] - xs[b]), h = 1 + std::abs(ys[a] - ys[b]);
+                best = std::max(best, w * h);
+            }
         }
-    }
-    return part1;
+        return static_cast<long>(best);
+    };
+    return prelude::simd::dispatch(largest, corners.field<X>(), corners.field<Y>());
 }
 
 struct Edge {
     double constant, begin, end;
 };
 
+} // namespace
+
 template <> struct fmt::formatter<Edge> : fmt::formatter<std::string_view> {
     auto format(const Edge &e, fmt::format_context &ctx) const {
         std::string s = fmt::format("({}, {}, {})", e.constant, e.begin, e.end);
@@ -38,6 +75,8 @@ template <> struct fmt::formatter<Edge> : fmt::formatter<std::string_view> {
     }
 };
 
+namespace {
+
 std::pair<std::vector<Edge>, std::vector<Edge>> edges(const std::vector<Point> &points) {
     std::vector<Edge> h, v;
     for (auto [a, b] : prelude::pairwise(points)) {
@@ -82,7 +121,9 @@ bool isRectIntruded(const Point &min, const Point &max, const std::vector<Edge>
     return false;
 }
 
-long calc_part2(std::vector<Point> &points) {
+long calc_part2(const Corners &corners) {
+    auto points = corners | rv::transform([](auto c) { return std::make_from_tuple<Point>(c); })
+                  | prelude::collect<std::vector>;
     points.push_back(points.front());
     auto [ve, he] = edges(points);
 
@@ -112,27 +153,19 @@ long calc_part2(std::vector<Point> &points) {
     return part2;
 }
 
-int main(int, char **) {
-    auto points = prelude::line_view(std::cin) | rv::transform([](const std::string &line) {
-                      auto parts = line | rv::split(',') | rv::transform([](auto &&r) {
-                                       return std::stol(std::string(r.begin(), r.end()));
-                                   });
-                      auto it = parts.begin();
-                      long x = *it++;
-                      long y = *it++;
-                      return Point{static_cast<double>(x), static_cast<double>(y)};
-                  })
-                  | prelude::collect<std::vector>;
-    // std::sort(points.begin(), points.end());
-    points.erase(std::unique(points.begin(), points.end()), points.end());
-
-    long part1 = calc_part1(points);
+Corners parse(std::string_view input) {
+    auto corners = prelude::par_lines(input, [](std::string_view line) {
+        return prelude::ints<2>(line);
+    });
+    corners.erase(std::unique(corners.begin(), corners.end()), corners.end());
+    return Corners(corners);
+}
 
-    fmt::print("part 1: {}\n", part1);
+void save(const Corners &corners, prelude::column_writer &out) { out.soa(corners); }
 
-    long part2 = calc_part2(points);
+Corners load(prelude::column_reader &in) { return in.soa<double, double>(); }
 
-    fmt::print("part 2: {}\n", part2);
+} // namespace
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(2025, 9, parse, calc_part1, calc_part2);
+AOC_SOLUTION_COLUMNS(2025, 9, save, load);
\ No newline at end of file
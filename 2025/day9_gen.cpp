@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <vector>
+
+#include "prelude/gen.hpp"
+
+// A random orthogonal polygon that's simple by construction: k columns side
+// by side, column i spanning [x[i], x[i + 1]] horizontally and
+// [bottom[i], top[i]] vertically, with every top above the middle and every
+// bottom below it so neighbouring columns always overlap. Walking the tops
+// left to right and the bottoms back gives 4k red tiles, in order.
+void generate(prelude::gen_args &args, prelude::gen_out &out) {
+    const long n = args.get("n", 496l, "number of red tiles, rounded down to a multiple of 4");
+    const long max = args.get("max", 100000l, "coordinates are in [0, max]");
+    prelude::rng rng(args.seed());
+    args.done();
+    const long k = n / 4;
+    args.check(k >= 1, "n must be at least 4");
+    args.check(max >= 4 && k + 1 <= max + 1, "max is too small for that many tiles");
+
+    // k + 1 distinct xs: top up with fresh samples until the repeats are gone,
+    // or when that would take a while, shuffle the whole range.
+    std::vector<long> xs;
+    if (k + 1 <= (max + 1) / 2) {
+        while (static_cast<long>(xs.size()) < k + 1) {
+            for (long i = xs.size(); i < k + 1; ++i) {
+                xs.push_back(rng.uniform(0l, max));
+            }
+            std::ranges::sort(xs);
+            xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+        }
+    } else {
+        for (long x = 0; x <= max; ++x) {
+            xs.push_back(x);
+        }
+        rng.shuffle(xs);
+        xs.resize(k + 1);
+        std::ranges::sort(xs);
+    }
+
+    const long mid = max / 2;
+    std::vector<long> top(k), bottom(k);
+    for (long i = 0; i < k; ++i) {
+        do {
+            top[i] = rng.uniform(mid + 1, max);
+        } while (i > 0 && top[i] == top[i - 1]);
+        do {
+            bottom[i] = rng.uniform(0l, mid - 1);
+        } while (i > 0 && bottom[i] == bottom[i - 1]);
+    }
+
+    for (long i = 0; i < k; ++i) {
+        out.print("{},{}\n{},{}\n", xs[i], top[i], xs[i + 1], top[i]);
+    }
+    for (long i = k - 1; i >= 0; --i) {
+        out.print("{},{}\n{},{}\n", xs[i + 1], bottom[i], xs[i], bottom[i]);
+    }
+}
+
+int main(int argc, char **argv) {
+    return prelude::gen_main(argc, argv, "2025 day 9: a loop of red tiles.", generate);
+}
@@ -1,8 +1,110 @@
-
 def aoc(day, linkopts = []):
-    native.cc_binary(
-        name = "day{}".format(day),
+    # The day's code proper: parse/part1/part2 plus its AOC_SOLUTION. It has
+    # no main() and only registers itself from a static initializer, hence
+    # alwayslink.
+    native.cc_library(
+        name = "day{}_lib".format(day),
         srcs = ["day{}.cpp".format(day)],
         deps = ["//prelude:prelude", "@fmt//:fmt", "@spdlog//:spdlog"],
         linkopts = linkopts,
+        alwayslink = True,
+    )
+    native.cc_binary(
+        name = "day{}".format(day),
+        deps = [":day{}_lib".format(day), "//prelude:main"] + select({
+            "//prelude:alloc": ["//prelude:alloc_tracker"],
+            "//conditions:default": [],
+        }),
+    )
+    aoc_bench(day)
+    aoc_gen(day)
+    aoc_test(day)
+    aoc_fixture(day, linkopts)
+    aoc_example(day, linkopts)
+
+def aoc_bench(day):
+    native.cc_binary(
+        name = "day{}_bench".format(day),
+        deps = [":day{}_lib".format(day), "//prelude:bench_main"],
+    )
+
+def aoc_fixture(day, linkopts = []):
+    # fixtures/dayN.txt, where there is one (they're puzzle inputs, so not
+    # checked in), gets a dayN_fixture binary with that input compiled in and
+    # parsed at compile time as far as the day goes (see prelude/embedded.hpp).
+    fixture = native.glob(["fixtures/day{}.txt".format(day)], allow_empty = True)
+    if fixture:
+        aoc_embedded("day{}_fixture".format(day), day, fixture[0], linkopts)
+
+def aoc_example(day, linkopts = []):
+    # examples/dayN.txt, an example from the puzzle text (so it can be checked
+    # in), builds the same way as a fixture, and dayN_example_test checks that
+    # it prints what examples/dayN.answers says.
+    example = native.glob(["examples/day{}.txt".format(day)], allow_empty = True)
+    answers = native.glob(["examples/day{}.answers".format(day)], allow_empty = True)
+    if not example or not answers:
+        return
+    binary = "day{}_example".format(day)
+    aoc_embedded(binary, day, example[0], linkopts)
+    native.sh_test(
+        name = "day{}_example_test".format(day),
+        size = "small",
+        srcs = ["//bzl:embedded_test.sh"],
+        args = ["$(rootpath :{})".format(binary), "$(rootpath {})".format(answers[0])],
+        data = [":" + binary, answers[0]],
+    )
+
+def aoc_embedded(name, day, input, linkopts = []):
+    # The input goes in as a string literal of \xNN escapes rather than by
+    # #embed, which our compilers don't have yet. The day is compiled again
+    # rather than linked from dayN_lib, since it's built differently.
+    inc = "{}_input.inc".format(name)
+    native.genrule(
+        name = "{}_input".format(name),
+        srcs = [input],
+        outs = [inc],
+        cmd = "(echo '\"\"'; od -An -v -tx1 $< | " +
+              "sed -e 's/ *\\([0-9a-f][0-9a-f]\\)/\\\\x\\1/g' -e 's/.*/\"&\"/') > $@",
+    )
+    native.cc_binary(
+        name = name,
+        srcs = ["day{}.cpp".format(day), inc],
+        copts = ["-DAOC_EMBEDDED_INPUT=\\\"{}/{}\\\"".format(native.package_name(), inc)],
+        deps = ["//prelude:prelude", "//prelude:embedded_main", "@fmt//:fmt", "@spdlog//:spdlog"],
+        linkopts = linkopts,
+    )
+
+def aoc_gen(day):
+    # dayN_gen.cpp, where there is one, writes synthetic inputs for the day.
+    srcs = native.glob(["day{}_gen.cpp".format(day)], allow_empty = True)
+    if srcs:
+        native.cc_binary(
+            name = "day{}_gen".format(day),
+            srcs = srcs,
+            deps = ["//prelude:prelude", "@fmt//:fmt"],
+        )
+
+def aoc_test(day):
+    # dayN_test.cpp, where there is one, tests the day through the registry,
+    # like main() would find it.
+    srcs = native.glob(["day{}_test.cpp".format(day)], allow_empty = True)
+    if srcs:
+        native.cc_test(
+            name = "day{}_test".format(day),
+            size = "small",
+            srcs = srcs,
+            deps = [
+                ":day{}_lib".format(day),
+                "//prelude:prelude",
+                "@googletest//:gtest",
+                "@googletest//:gtest_main",
+            ],
+        )
+
+def aoc_year():
+    # Every day above in one library, for //:aoc_all. Call it last.
+    native.cc_library(
+        name = "days",
+        deps = sorted([":" + name for name in native.existing_rules() if name.endswith("_lib")]),
+        visibility = ["//visibility:public"],
     )
@@ -0,0 +1,7 @@
+#!/bin/sh
+# Runs a binary with its input compiled in (aoc_example in aoc.bzl) and checks
+# it prints the answers in the file:
+#
+#     embedded_test.sh BINARY ANSWERS
+set -eu
+"$1" | diff -u "$2" -
@@ -0,0 +1,171 @@
+// main() for aoc_all, which has every day linked in: run any of them, side by
+// side on the shared pool, each over its own input.
+//
+//     aoc_all [--inputs=DIR] [--timing=PATH] [--perf] [--trace=PATH] [--cache=DIR] [DAY...]
+//
+// A DAY is a day like 2025/day8 or a whole year like 2025; with none, every
+// day that has an input. Day YEAR/dayN reads DIR/YEAR/dayN.txt, with DIR
+// inputs by default. The answers come out in order once every day is done.
+//
+// --timing, --perf and --trace work as they do for a single day (main.cpp),
+// giving one report with each day's phases under its name, e.g.
+// "2025/day8/parse". With days running at once the CPU times and hardware
+// counters are the whole process's, so they overlap; wall times don't.
+// --cache (or $AOC_CACHE) is the answer cache, as for a single day.
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#include "prelude/aoc.hpp"
+#include "prelude/cache.hpp"
+#include "prelude/input.hpp"
+#include "prelude/parallel.hpp"
+#include "prelude/simd.hpp"
+#include "prelude/timing.hpp"
+#include "prelude/trace.hpp"
+
+namespace {
+
+std::string input_path(const std::string &dir, const prelude::solution &s) {
+    return fmt::format("{}/{}/day{}.txt", dir, s.year, s.day);
+}
+
+// Whether DAY argument w names s.
+bool names(std::string_view w, const prelude::solution &s) {
+    return w == s.name() || w == std::to_string(s.year);
+}
+
+struct outcome {
+    prelude::answers answers;
+    std::string error; // empty if it ran
+};
+
+outcome run(const prelude::solution &s, const std::string &path,
+            const prelude::answer_cache *cache) {
+    prelude::scoped_timer t(prelude::scoped_timer::top_level, s.name());
+    AOC_TRACE_SPAN("day", "day", s.year * 100L + s.day);
+    try {
+        std::optional<prelude::mapped_input> input;
+        {
+            prelude::scoped_timer t("read");
+            AOC_TRACE_SPAN("read");
+            input.emplace(path);
+        }
+        return {prelude::solve(s, input->text(), cache), {}};
+    } catch (const std::exception &e) {
+        return {{}, e.what()};
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string inputs = "inputs";
+    std::vector<std::string> wanted;
+    bool perf = false;
+    std::optional<std::string> cache_dir;
+    if (const char *env = std::getenv("AOC_CACHE"); env && *env) {
+        cache_dir = env;
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--inputs=")) {
+            inputs = arg.substr(9);
+        } else if (arg.starts_with("--timing=")) {
+            prelude::timing().enable(std::string(arg.substr(9)));
+        } else if (arg == "--perf") {
+            perf = true;
+        } else if (arg.starts_with("--trace=")) {
+#ifdef AOC_TRACE
+            prelude::trace().enable(std::string(arg.substr(8)));
+#else
+            spdlog::warn("built without tracing, ignoring --trace (build with --define trace=1)");
+#endif
+        } else if (arg.starts_with("--cache=")) {
+            cache_dir = arg.substr(8);
+        } else if (!arg.starts_with("--")) {
+            wanted.emplace_back(arg);
+        } else {
+            spdlog::error("usage: {} [--inputs=DIR] [--timing=PATH] [--perf] [--trace=PATH] "
+                          "[--cache=DIR] [DAY...]",
+                          argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<const prelude::solution *> days;
+    for (const auto &s : prelude::registry()) {
+        days.push_back(&s);
+    }
+    std::ranges::sort(days, {}, [](auto *s) { return std::pair(s->year, s->day); });
+    for (const auto &w : wanted) {
+        if (std::ranges::none_of(days, [&w](auto *s) { return names(w, *s); })) {
+            spdlog::error("no such day: {}", w);
+            return 1;
+        }
+    }
+    std::erase_if(days, [&](auto *s) {
+        if (wanted.empty()) {
+            return !std::filesystem::exists(input_path(inputs, *s));
+        }
+        return std::ranges::none_of(wanted, [s](const auto &w) { return names(w, *s); });
+    });
+    if (days.empty()) {
+        spdlog::error("no inputs under {}", inputs);
+        return 1;
+    }
+
+    auto &timing = prelude::timing();
+    if (perf) {
+        timing.enable_perf();
+        if (!timing.enabled()) {
+            timing.enable("-");
+        }
+    }
+    timing.annotate("inputs", inputs);
+    timing.annotate("days", static_cast<long>(days.size()));
+    timing.annotate("simd", prelude::simd::name(prelude::simd::current()));
+
+    std::optional<prelude::answer_cache> cache;
+    if (cache_dir) {
+        try {
+            cache.emplace(*cache_dir);
+            timing.annotate("cache", *cache_dir);
+        } catch (const std::exception &e) {
+            spdlog::warn("not caching answers: {}", e.what());
+        }
+    }
+
+    std::vector<outcome> outcomes(days.size());
+    {
+        prelude::scoped_timer t("all");
+        prelude::default_pool().parallel_for(days.size(), [&](size_t i) {
+            outcomes[i] = run(*days[i], input_path(inputs, *days[i]), cache ? &*cache : nullptr);
+        });
+    }
+
+    int status = 0;
+    for (size_t i = 0; i < days.size(); ++i) {
+        const auto &s = *days[i];
+        const auto &o = outcomes[i];
+        if (!o.error.empty()) {
+            spdlog::error("{}: {}", s.name(), o.error);
+            status = 1;
+            continue;
+        }
+        fmt::print("{} part 1: {}\n", s.name(), o.answers.part1);
+        if (s.part2) {
+            fmt::print("{} part 2: {}\n", s.name(), o.answers.part2);
+        }
+    }
+    return status;
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+// Heap allocation accounting. Linking //prelude:alloc_tracker into a binary
+// (the day binaries get it with bazel build --define alloc=1) replaces the
+// global operator new and delete with versions that count into the counters
+// here, and the phase timings (timing.hpp) then report allocations, bytes
+// allocated and peak live heap bytes for every phase. Without the tracker
+// linked in everything here stays at zero and alloc_tracking() is false.
+//
+// The counters are process-wide, so a phase that runs on the pool is charged
+// for what every thread allocated while it ran, and its peak is the most the
+// whole process had live. Scopes open at once on different threads (aoc_all's
+// days, batch mode's inputs) each keep their own high-water mark. Only a
+// thread's innermost scope is raised by every allocation; the ones around it
+// take its peak when it ends, so nesting doesn't cost each allocation more.
+
+namespace prelude {
+
+struct alloc_stats {
+    long count = 0; // calls to operator new
+    long bytes = 0; // bytes they asked for, as malloc rounded them
+    long peak = 0;  // most heap bytes live at once; -1 if it wasn't tracked
+};
+
+namespace detail {
+// How many threads can have a scope tracking its peak at once; scopes past
+// that get peak -1.
+inline constexpr size_t alloc_peak_slots = 256;
+
+// A line each, so scopes on different threads don't share one.
+struct alignas(64) alloc_peak {
+    std::atomic<long> value{0};
+};
+
+struct alloc_counters {
+    std::atomic<bool> tracking{false};
+    std::atomic<long> count{0};
+    std::atomic<long> bytes{0};
+    std::atomic<long> live{0};
+    // A bit per slot of peaks, set while an alloc_scope has it.
+    std::atomic<uint64_t> in_use[alloc_peak_slots / 64]{};
+    // The high-water mark of live since that scope began.
+    alloc_peak peaks[alloc_peak_slots]{};
+};
+
+inline constinit alloc_counters allocs;
+
+inline void raise_to(std::atomic<long> &peak, long live) {
+    long p = peak.load(std::memory_order_relaxed);
+    while (live > p && !peak.compare_exchange_weak(p, live, std::memory_order_relaxed)) {
+    }
+}
+
+inline void note_alloc(long n) {
+    allocs.count.fetch_add(1, std::memory_order_relaxed);
+    allocs.bytes.fetch_add(n, std::memory_order_relaxed);
+    const long live = allocs.live.fetch_add(n, std::memory_order_relaxed) + n;
+    for (size_t w = 0; w < std::size(allocs.in_use); ++w) {
+        for (uint64_t m = allocs.in_use[w].load(std::memory_order_relaxed); m; m &= m - 1) {
+            raise_to(allocs.peaks[w * 64 + std::countr_zero(m)].value, live);
+        }
+    }
+}
+
+inline void note_free(long n) { allocs.live.fetch_sub(n, std::memory_order_relaxed); }
+
+// A free slot of allocs.peaks, starting from what's live now; -1 if there's
+// none.
+inline long claim_peak() {
+    for (size_t w = 0; w < std::size(allocs.in_use); ++w) {
+        uint64_t m = allocs.in_use[w].load(std::memory_order_relaxed);
+        while (~m != 0) {
+            const int bit = std::countr_one(m);
+            if (allocs.in_use[w].compare_exchange_weak(m, m | uint64_t{1} << bit,
+                                                       std::memory_order_relaxed)) {
+                auto &peak = allocs.peaks[w * 64 + bit].value;
+                peak.store(allocs.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                // Anything allocated while that was being stored.
+                raise_to(peak, allocs.live.load(std::memory_order_relaxed));
+                return static_cast<long>(w * 64 + bit);
+            }
+        }
+    }
+    return -1;
+}
+
+inline void release_peak(long slot) {
+    allocs.in_use[slot / 64].fetch_and(~(uint64_t{1} << (slot % 64)), std::memory_order_relaxed);
+}
+} // namespace detail
+
+inline bool alloc_tracking() { return detail::allocs.tracking.load(std::memory_order_relaxed); }
+
+// What was allocated between construction and stats(). Scopes on a thread
+// are kept in a list, innermost last; one that ends out of order (not
+// innermost) just leaves it. A scope has to end on the thread it began on.
+class alloc_scope {
+    static inline thread_local alloc_scope *tl_innermost = nullptr;
+
+    long _count, _bytes;
+    long _slot = -1;         // of allocs.peaks, while this is innermost
+    long _peak = 0;          // the rest of its peak: before and inside inner scopes
+    bool _untracked = false; // some of it went without a slot
+    alloc_scope *_outer = nullptr;
+    alloc_scope *_inner = nullptr;
+
+    void track() {
+        _slot = detail::claim_peak();
+        _untracked |= _slot < 0;
+    }
+
+    void untrack() {
+        if (_slot >= 0) {
+            const auto &peak = detail::allocs.peaks[_slot].value;
+            _peak = std::max(_peak, peak.load(std::memory_order_relaxed));
+            detail::release_peak(_slot);
+            _slot = -1;
+        }
+    }
+
+    long peak() const {
+        long p = _peak;
+        if (_slot >= 0) {
+            p = std::max(p, detail::allocs.peaks[_slot].value.load(std::memory_order_relaxed));
+        }
+        if (_inner) {
+            const long inner = _inner->peak();
+            if (inner < 0) {
+                return -1;
+            }
+            p = std::max(p, inner);
+        }
+        return _untracked ? -1 : p;
+    }
+
+  public:
+    alloc_scope() : _outer(tl_innermost) {
+        auto &a = detail::allocs;
+        _count = a.count.load(std::memory_order_relaxed);
+        _bytes = a.bytes.load(std::memory_order_relaxed);
+        if (_outer) {
+            _outer->untrack();
+            _outer->_inner = this;
+        }
+        tl_innermost = this;
+        track();
+    }
+
+    alloc_scope(const alloc_scope &) = delete;
+    alloc_scope &operator=(const alloc_scope &) = delete;
+
+    ~alloc_scope() {
+        untrack();
+        if (_outer) {
+            // all of this was inside the outer one
+            _outer->_peak = std::max(_outer->_peak, _peak);
+            _outer->_untracked |= _untracked;
+            _outer->_inner = _inner;
+        }
+        if (_inner) {
+            _inner->_outer = _outer;
+        } else {
+            tl_innermost = _outer;
+            if (_outer) {
+                _outer->track();
+            }
+        }
+    }
+
+    alloc_stats stats() const {
+        auto &a = detail::allocs;
+        return {a.count.load(std::memory_order_relaxed) - _count,
+                a.bytes.load(std::memory_order_relaxed) - _bytes, peak()};
+    }
+};
+
+} // namespace prelude
@@ -0,0 +1,106 @@
+// Runs with the allocation tracker linked in, to keep the parsing helpers
+// that are meant to be allocation-free that way.
+
+#include <bit>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "prelude/alloc.hpp"
+#include "prelude/input.hpp"
+#include "prelude/prelude.hpp"
+
+TEST(AllocTest, TestCounts) {
+    ASSERT_TRUE(prelude::alloc_tracking());
+
+    prelude::alloc_scope outer;
+    {
+        std::vector<long> v(1000);
+        prelude::alloc_scope inner;
+        std::vector<long> w(10);
+        EXPECT_EQ(inner.stats().count, 1);
+        EXPECT_GE(inner.stats().bytes, 80);
+    }
+    auto s = outer.stats();
+    EXPECT_EQ(s.count, 2);
+    EXPECT_GE(s.bytes, 8080);
+    // the outer scope's own high-water mark, whatever the inner one saw
+    EXPECT_GE(s.peak, 8080);
+}
+
+TEST(AllocTest, TestNestedScopes) {
+    // Only a thread's innermost scope is raised by each allocation; the ones
+    // around it take its peak when it ends.
+    auto slots_in_use = [] {
+        int n = 0;
+        for (const auto &w : prelude::detail::allocs.in_use) {
+            n += std::popcount(w.load());
+        }
+        return n;
+    };
+    prelude::alloc_scope outer;
+    {
+        prelude::alloc_scope middle;
+        prelude::alloc_scope inner;
+        EXPECT_EQ(slots_in_use(), 1);
+        { std::vector<char> big(1 << 20); }
+        EXPECT_GE(inner.stats().peak, 1 << 20);
+        EXPECT_GE(outer.stats().peak, 1 << 20);
+    }
+    EXPECT_EQ(slots_in_use(), 1);
+    EXPECT_GE(outer.stats().peak, 1 << 20);
+}
+
+TEST(AllocTest, TestOverlappingScopes) {
+    // Scopes that start and end out of order, as they do on the pool's
+    // threads, each keep their own peak.
+    std::optional<prelude::alloc_scope> a(std::in_place);
+    { std::vector<char> big(1 << 20); }
+    std::optional<prelude::alloc_scope> b(std::in_place);
+    const long a_peak = a->stats().peak;
+    EXPECT_GE(a_peak, 1 << 20);
+    EXPECT_LT(b->stats().peak, a_peak);
+    a.reset();
+    { std::vector<char> small(1 << 10); }
+    EXPECT_GE(b->stats().peak, 1 << 10);
+    EXPECT_LT(b->stats().peak, a_peak);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([] {
+            for (int j = 0; j < 100; ++j) {
+                prelude::alloc_scope scope;
+                { std::vector<char> v(4096); }
+                EXPECT_GE(scope.stats().peak, 4096);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+}
+
+TEST(AllocTest, TestParsersDontAllocate) {
+    constexpr std::string_view text = "move 3 from 1 to -2\n  turn on 0,0 through 999,999  \n";
+
+    prelude::alloc_scope scope;
+    long total = 0;
+    for (auto line : prelude::lines(text)) {
+        for (long x : prelude::ints(line)) {
+            total += x;
+        }
+        for (auto word : prelude::tokens(prelude::chomp(line))) {
+            total += static_cast<long>(word.size());
+        }
+    }
+    auto [a, b, c] = prelude::ints<3>(text);
+    auto parsed = prelude::scan<"move {} from {} to {}", int, int, int>(text.substr(0, 19));
+
+    EXPECT_EQ(scope.stats().count, 0);
+    EXPECT_EQ(total, 3 + 1 - 2 + 999 + 999 + 14 + 23);
+    EXPECT_EQ(a + b + c, 2);
+    EXPECT_TRUE(parsed);
+}
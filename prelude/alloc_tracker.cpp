@@ -0,0 +1,86 @@
+// Global operator new and delete that count into prelude::detail::allocs.
+// Link this in (alwayslink) to get allocation numbers; see alloc.hpp.
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include <malloc.h>
+
+#include "prelude/alloc.hpp"
+
+namespace {
+
+[[maybe_unused]] const bool tracking = [] {
+    prelude::detail::allocs.tracking.store(true);
+    return true;
+}();
+
+// Sizes are whatever malloc actually handed out, so a free can be charged
+// without the caller telling us its size.
+void *allocate(std::size_t n) {
+    void *p = std::malloc(n ? n : 1);
+    if (p) {
+        prelude::detail::note_alloc(static_cast<long>(malloc_usable_size(p)));
+    }
+    return p;
+}
+
+void *allocate(std::size_t n, std::align_val_t align) {
+    void *p = nullptr;
+    const std::size_t a = std::max(sizeof(void *), static_cast<std::size_t>(align));
+    if (posix_memalign(&p, a, n ? n : 1) != 0) {
+        return nullptr;
+    }
+    prelude::detail::note_alloc(static_cast<long>(malloc_usable_size(p)));
+    return p;
+}
+
+void release(void *p) noexcept {
+    if (p) {
+        prelude::detail::note_free(static_cast<long>(malloc_usable_size(p)));
+        std::free(p);
+    }
+}
+
+template <typename... A> void *allocate_or_throw(std::size_t n, A... a) {
+    while (true) {
+        if (void *p = allocate(n, a...)) {
+            return p;
+        }
+        if (std::new_handler handler = std::get_new_handler()) {
+            handler();
+        } else {
+            throw std::bad_alloc();
+        }
+    }
+}
+
+} // namespace
+
+void *operator new(std::size_t n) { return allocate_or_throw(n); }
+void *operator new[](std::size_t n) { return allocate_or_throw(n); }
+void *operator new(std::size_t n, std::align_val_t a) { return allocate_or_throw(n, a); }
+void *operator new[](std::size_t n, std::align_val_t a) { return allocate_or_throw(n, a); }
+
+void *operator new(std::size_t n, const std::nothrow_t &) noexcept { return allocate(n); }
+void *operator new[](std::size_t n, const std::nothrow_t &) noexcept { return allocate(n); }
+void *operator new(std::size_t n, std::align_val_t a, const std::nothrow_t &) noexcept {
+    return allocate(n, a);
+}
+void *operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t &) noexcept {
+    return allocate(n, a);
+}
+
+void operator delete(void *p) noexcept { release(p); }
+void operator delete[](void *p) noexcept { release(p); }
+void operator delete(void *p, std::size_t) noexcept { release(p); }
+void operator delete[](void *p, std::size_t) noexcept { release(p); }
+void operator delete(void *p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { release(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { release(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { release(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { release(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { release(p); }
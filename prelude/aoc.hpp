@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "prelude/arena.hpp"
+#include "prelude/columnar.hpp"
+#include "prelude/embedded.hpp"
+#include "prelude/timing.hpp"
+#include "prelude/trace.hpp"
+
+// The shape every day has from the outside: parse the input text once, then
+// answer part 1 and part 2 from what was parsed. Days register themselves
+// with AOC_SOLUTION and leave main() to whoever links them (the day binary,
+// its benchmark, aoc_all with every day at once, ...). That last one is why
+// everything else a day defines goes in an anonymous namespace:
+//
+//     namespace {
+//     std::vector<Package> parse(std::string_view input);
+//     int part1(const std::vector<Package> &);
+//     int part2(const std::vector<Package> &);
+//     } // namespace
+//
+//     AOC_SOLUTION(2015, 2, parse, part1, part2);
+//
+// parse may hand back views into the input text; the text outlives the parts.
+// A parse that takes a std::pmr::memory_resource * as well gets an arena
+// (arena.hpp) to build into, which lives exactly as long as what it returns:
+//
+//     prelude::pmr::vector<Row> parse(std::string_view input, std::pmr::memory_resource *mr);
+//
+// A part that wants to scribble on its input can take it by value (or by
+// non-const reference) and gets its own copy, so the phases can be run
+// independently and repeatedly.
+//
+// A day whose answers change (a bug fixed, say) bumps its version, so answers
+// cached for the old one (cache.hpp) aren't handed out again. It goes after
+// the AOC_SOLUTION it's for:
+//
+//     AOC_SOLUTION_VERSION(2015, 2, 2);
+//
+// A day can also save what parse gives it as columns (columnar.hpp), so its
+// binary can be handed the saved file instead of the text and skip parsing.
+// save and load go after AOC_SOLUTION too, and load has to give back what
+// parse does:
+//
+//     void save(const std::vector<Package> &, prelude::column_writer &);
+//     std::vector<Package> load(prelude::column_reader &);
+//
+//     AOC_SOLUTION_COLUMNS(2015, 2, save, load);
+//
+// A day built with its input compiled in (embedded.hpp) can hand over what it
+// parsed from it at compile time, again the same type parse gives:
+//
+//     std::vector<Package> embedded();
+//
+//     AOC_SOLUTION_EMBEDDED(2015, 2, embedded);
+
+namespace prelude {
+
+struct solution {
+    int year = 0;
+    int day = 0;
+    std::function<std::shared_ptr<const void>(std::string_view)> parse;
+    std::function<std::string(const void *)> part1;
+    std::function<std::string(const void *)> part2; // empty for days with one part
+    int version = 1;
+    const std::type_info *input = nullptr; // what parse gives
+    // For days with AOC_SOLUTION_COLUMNS; empty otherwise.
+    std::function<void(const void *, column_writer &)> save;
+    std::function<std::shared_ptr<const void>(column_reader &)> load;
+    // For days with AOC_SOLUTION_EMBEDDED; empty otherwise.
+    std::function<std::shared_ptr<const void>()> embedded;
+
+    std::string name() const { return fmt::format("{}/day{}", year, day); }
+};
+
+struct answers {
+    std::string part1;
+    std::string part2;
+};
+
+inline std::vector<solution> &registry() {
+    static std::vector<solution> solutions;
+    return solutions;
+}
+
+namespace detail {
+template <typename Input, typename Part> std::function<std::string(const void *)> erase(Part part) {
+    return [part](const void *p) {
+        const Input &input = *static_cast<const Input *>(p);
+        if constexpr (std::is_invocable_v<const Part &, const Input &>) {
+            return fmt::format("{}", std::invoke(part, input));
+        } else {
+            Input copy = input;
+            return fmt::format("{}", std::invoke(part, copy));
+        }
+    };
+}
+
+// The result of a parse(text, mr), kept together with the arena it was built
+// in. The arena is declared first, so it's destroyed last.
+template <typename Input> struct in_arena {
+    arena mem;
+    Input input;
+
+    template <typename Parse>
+    in_arena(const Parse &parse, std::string_view text)
+        : input(std::invoke(parse, text, mem.resource())) {}
+};
+
+template <typename Parse> auto parse_result() {
+    if constexpr (std::is_invocable_v<Parse &, std::string_view, std::pmr::memory_resource *>) {
+        return std::type_identity<std::decay_t<
+            std::invoke_result_t<Parse &, std::string_view, std::pmr::memory_resource *>>>{};
+    } else {
+        return std::type_identity<std::decay_t<std::invoke_result_t<Parse &, std::string_view>>>{};
+    }
+}
+} // namespace detail
+
+template <typename Parse, typename Part1, typename Part2 = std::nullptr_t>
+solution make_solution(int year, int day, Parse parse, Part1 part1, Part2 part2 = nullptr) {
+    using Input = typename decltype(detail::parse_result<Parse>())::type;
+
+    solution s;
+    s.year = year;
+    s.day = day;
+    s.input = &typeid(Input);
+    s.parse = [parse](std::string_view text) -> std::shared_ptr<const void> {
+        if constexpr (std::is_invocable_v<Parse &, std::string_view, std::pmr::memory_resource *>) {
+            auto p = std::make_shared<const detail::in_arena<Input>>(parse, text);
+            return std::shared_ptr<const void>(p, &p->input);
+        } else {
+            return std::make_shared<const Input>(std::invoke(parse, text));
+        }
+    };
+    s.part1 = detail::erase<Input>(part1);
+    if constexpr (!std::is_null_pointer_v<Part2>) {
+        s.part2 = detail::erase<Input>(part2);
+    }
+    return s;
+}
+
+struct registrar {
+    template <typename... Args> registrar(int year, int day, Args &&...args) {
+        registry().push_back(make_solution(year, day, std::forward<Args>(args)...));
+    }
+};
+
+namespace detail {
+// The solution a macro that goes after AOC_SOLUTION is about.
+inline solution &registered(int year, int day, std::string_view macro) {
+    auto it = std::ranges::find_if(
+        registry(), [&](const solution &s) { return s.year == year && s.day == day; });
+    if (it == registry().end()) {
+        throw std::logic_error(
+            fmt::format("{} before AOC_SOLUTION for {}/day{}", macro, year, day));
+    }
+    return *it;
+}
+} // namespace detail
+
+struct versioner {
+    versioner(int year, int day, int version) {
+        detail::registered(year, day, "AOC_SOLUTION_VERSION").version = version;
+    }
+};
+
+struct columns_registrar {
+    template <typename Save, typename Load>
+    columns_registrar(int year, int day, Save save, Load load) {
+        using Input = std::decay_t<std::invoke_result_t<Load &, column_reader &>>;
+        solution &s = detail::registered(year, day, "AOC_SOLUTION_COLUMNS");
+        if (*s.input != typeid(Input)) {
+            throw std::logic_error(
+                fmt::format("AOC_SOLUTION_COLUMNS for {}: load doesn't give what parse does",
+                            s.name()));
+        }
+        s.save = [save](const void *p, column_writer &out) {
+            std::invoke(save, *static_cast<const Input *>(p), out);
+        };
+        s.load = [load](column_reader &in) -> std::shared_ptr<const void> {
+            return std::make_shared<const Input>(std::invoke(load, in));
+        };
+    }
+};
+
+struct embedded_registrar {
+    template <typename Embedded> embedded_registrar(int year, int day, Embedded embedded) {
+        using Input = std::decay_t<std::invoke_result_t<Embedded &>>;
+        solution &s = detail::registered(year, day, "AOC_SOLUTION_EMBEDDED");
+        if (*s.input != typeid(Input)) {
+            throw std::logic_error(fmt::format(
+                "AOC_SOLUTION_EMBEDDED for {}: it doesn't give what parse does", s.name()));
+        }
+        s.embedded = [embedded]() -> std::shared_ptr<const void> {
+            return std::make_shared<const Input>(std::invoke(embedded));
+        };
+    }
+};
+
+// What parse gives for text, or load for a columnar file.
+inline std::shared_ptr<const void> parse_input(const solution &s, std::string_view text) {
+    if (!is_columnar(text)) {
+        scoped_timer t("parse");
+        AOC_TRACE_SPAN("parse");
+        return s.parse(text);
+    }
+    if (!s.load) {
+        throw std::runtime_error(fmt::format("{} has no columnar format", s.name()));
+    }
+    scoped_timer t("load");
+    AOC_TRACE_SPAN("load");
+    column_reader in(text, s.year, s.day, s.version);
+    return s.load(in);
+}
+
+// text parsed and saved as a columnar file.
+inline std::string to_columnar(const solution &s, std::string_view text) {
+    if (!s.save) {
+        throw std::runtime_error(fmt::format("{} has no columnar format", s.name()));
+    }
+    auto input = parse_input(s, text);
+    scoped_timer t("save");
+    AOC_TRACE_SPAN("save");
+    column_writer out;
+    s.save(input.get(), out);
+    return out.bytes(s.year, s.day, s.version);
+}
+
+// Both parts, from what parse_input (or s.embedded) gave.
+inline answers solve_parsed(const solution &s, const void *input) {
+    answers a;
+    {
+        scoped_timer t("part1");
+        AOC_TRACE_SPAN("part1");
+        a.part1 = s.part1(input);
+    }
+    if (s.part2) {
+        scoped_timer t("part2");
+        AOC_TRACE_SPAN("part2");
+        a.part2 = s.part2(input);
+    }
+    return a;
+}
+
+// Parse (or load) and solve in one go, timing (and tracing) each phase.
+inline answers solve(const solution &s, std::string_view text) {
+    auto input = parse_input(s, text);
+    return solve_parsed(s, input.get());
+}
+
+} // namespace prelude
+
+#define AOC_SOLUTION(year, day, ...)                                                               \
+    static const ::prelude::registrar aoc_solution_##year##_##day { year, day, __VA_ARGS__ }
+
+#define AOC_SOLUTION_VERSION(year, day, version)                                                   \
+    static const ::prelude::versioner aoc_version_##year##_##day { year, day, version }
+
+#define AOC_SOLUTION_COLUMNS(year, day, save, load)                                                \
+    static const ::prelude::columns_registrar aoc_columns_##year##_##day { year, day, save, load }
+
+#define AOC_SOLUTION_EMBEDDED(year, day, embedded)                                                 \
+    static const ::prelude::embedded_registrar aoc_embedded_##year##_##day { year, day, embedded }
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A bump allocator for data that all dies together, like everything one parse
+// builds: allocations are carved out of a few big blocks and never freed
+// individually, and the whole lot goes back in one go when the arena does.
+// Hand it (it converts to a std::pmr::memory_resource *) to collect or to the
+// prelude::pmr containers:
+//
+//     prelude::arena arena;
+//     auto rows = lines(text) | rv::transform(parse_row)
+//                 | prelude::collect<prelude::pmr::vector>(arena);
+//
+// Days don't usually need their own: a parse(text, memory_resource *) gets an
+// arena that lives exactly as long as its result (see aoc.hpp).
+//
+// Not thread-safe; fill it from one thread.
+
+namespace prelude {
+
+class arena {
+    std::pmr::monotonic_buffer_resource _resource;
+
+  public:
+    explicit arena(size_t initial_bytes = size_t{1} << 16) : _resource(initial_bytes) {}
+
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    std::pmr::memory_resource *resource() { return &_resource; }
+    operator std::pmr::memory_resource *() { return &_resource; }
+
+    // Give everything back now rather than at destruction.
+    void release() { _resource.release(); }
+};
+
+// std::pmr containers under prelude's roof, so collect<prelude::pmr::vector>
+// reads like collect<std::vector>.
+namespace pmr {
+using std::pmr::map;
+using std::pmr::set;
+using std::pmr::string;
+using std::pmr::unordered_map;
+using std::pmr::vector;
+} // namespace pmr
+
+} // namespace prelude
@@ -0,0 +1,64 @@
+// main() for a day's benchmark: times parse, part 1 and part 2 separately
+// over one input file.
+//
+//     bazel run -c opt //2025:day8_bench -- [--benchmark_filter=...] input.txt
+//
+// The usual Google Benchmark flags (--benchmark_min_time,
+// --benchmark_repetitions, ...) control iterations; every benchmark warms up
+// for half a second before it's measured.
+
+#include <cstdio>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <fmt/core.h>
+
+#include "prelude/aoc.hpp"
+#include "prelude/input.hpp"
+
+namespace {
+constexpr double warmup_seconds = 0.5;
+
+void add(const std::string &name, auto body) {
+    benchmark::RegisterBenchmark(name.c_str(), body)
+        ->MinWarmUpTime(warmup_seconds)
+        ->Unit(benchmark::kMicrosecond);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    if (argc != 2) {
+        fmt::print(stderr, "usage: {} [benchmark flags] INPUT\n", argv[0]);
+        return 1;
+    }
+    const prelude::mapped_input input{std::string(argv[1])};
+    const std::string_view text = input.text();
+
+    for (const auto &s : prelude::registry()) {
+        auto parsed = s.parse(text);
+
+        add(s.name() + "/parse", [&s, text](benchmark::State &state) {
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(s.parse(text));
+            }
+            state.SetBytesProcessed(state.iterations() * text.size());
+        });
+        add(s.name() + "/part1", [&s, parsed](benchmark::State &state) {
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(s.part1(parsed.get()));
+            }
+        });
+        if (s.part2) {
+            add(s.name() + "/part2", [&s, parsed](benchmark::State &state) {
+                for (auto _ : state) {
+                    benchmark::DoNotOptimize(s.part2(parsed.get()));
+                }
+            });
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+
+#include "prelude/aoc.hpp"
+#include "prelude/hash.hpp"
+#include "prelude/timing.hpp"
+#include "prelude/trace.hpp"
+
+// Answers kept on disk, keyed by what was solved: the day, its version (see
+// AOC_SOLUTION_VERSION) and a hash of the input bytes. Solving an input that
+// has been solved before reads two strings back instead of parsing and
+// solving it again:
+//
+//     prelude::answer_cache cache("/tmp/aoc-cache");
+//     auto answers = prelude::solve(solution, text, &cache);
+//
+// Each entry is a file named by its key, written under a temporary name and
+// renamed into place, so writers in other threads or processes race
+// harmlessly and a reader never sees half an entry. A hit touches the file.
+// An entry that can't be read is a miss and one that can't be written is a
+// warning: the cache never fails a solve.
+//
+// The cache holds max_bytes of entries, and max_entries of them, since an
+// entry is a hundred bytes or so but takes a whole block on disk. It keeps a
+// running count of both rather than looking at the directory on every store;
+// the store that takes either past its limit scans the directory, deletes the
+// least recently used entries until both are down to three quarters of their
+// limits, and starts the count again from what's left. Entries other
+// processes add are only counted from the next scan. The scan also deletes
+// temporary files an hour old, which a writer that died left behind.
+//
+// The key is 128 bits of a fast non-cryptographic hash, which is plenty for
+// inputs we make ourselves but no defence against ones built to collide.
+
+namespace prelude {
+
+class answer_cache {
+    std::filesystem::path _dir;
+    uintmax_t _max_bytes;
+    uintmax_t _max_entries;
+    // What's in _dir as of the last scan, plus what we've stored since.
+    mutable std::atomic<uintmax_t> _bytes = 0;
+    mutable std::atomic<uintmax_t> _entries = 0;
+    mutable std::atomic<bool> _evicting = false;
+
+    // What an entry starts with, checked on the way back in.
+    static std::string header(const solution &s, std::string_view text) {
+        return fmt::format("aoc-cache {} v{} {}", s.name(), s.version, text.size());
+    }
+
+    std::filesystem::path entry(const solution &s, std::string_view text) const {
+        const uint64_t seed
+            = detail::hash_mix(s.year * 100ULL + s.day, detail::hash_k0) ^ s.version;
+        return _dir / fmt::format("{:016x}{:016x}",
+                                  detail::hash_bytes(text.data(), text.size(), seed),
+                                  detail::hash_bytes(text.data(), text.size(), ~seed));
+    }
+
+    // Stamped with the clock itself, not the kernel's coarser one for writes,
+    // so a store and a later hit are always in the right order.
+    static void touch(const std::filesystem::path &path) {
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    }
+
+    // Least recently used first, until what's left is well inside both
+    // limits. One thread at a time; any others storing meanwhile carry on.
+    void evict() const {
+        if (_evicting.exchange(true)) {
+            return;
+        }
+        std::error_code ec;
+        const auto stale = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+        std::vector<std::tuple<std::filesystem::file_time_type, uintmax_t, std::filesystem::path>>
+            entries;
+        uintmax_t total = 0;
+        for (const auto &e : std::filesystem::directory_iterator(_dir, ec)) {
+            if (!e.is_regular_file(ec)) {
+                continue;
+            }
+            const auto size = e.file_size(ec);
+            const auto time = e.last_write_time(ec);
+            if (ec) {
+                continue;
+            }
+            if (e.path().filename().string().starts_with(".")) {
+                if (time < stale) {
+                    std::filesystem::remove(e.path(), ec);
+                }
+                continue;
+            }
+            entries.emplace_back(time, size, e.path());
+            total += size;
+        }
+        const uintmax_t max_bytes = _max_bytes / 4 * 3, max_entries = _max_entries / 4 * 3;
+        size_t first = 0;
+        if (total > max_bytes || entries.size() > max_entries) {
+            std::ranges::sort(entries);
+            for (; first < entries.size(); ++first) {
+                if (total <= max_bytes && entries.size() - first <= max_entries) {
+                    break;
+                }
+                // Someone else may have got to it first; either way it's gone.
+                const auto &[time, size, path] = entries[first];
+                std::filesystem::remove(path, ec);
+                total -= size;
+            }
+        }
+        _bytes = total;
+        _entries = entries.size() - first;
+        _evicting = false;
+    }
+
+  public:
+    static constexpr uintmax_t default_max_bytes = uintmax_t{16} << 20;
+    static constexpr uintmax_t default_max_entries = 4096;
+
+    // Creates dir if it isn't there, and counts (and if need be trims) what's
+    // in it; throws std::filesystem::filesystem_error if it can't create it.
+    explicit answer_cache(std::filesystem::path dir, uintmax_t max_bytes = default_max_bytes,
+                          uintmax_t max_entries = default_max_entries)
+        : _dir(std::move(dir)), _max_bytes(max_bytes), _max_entries(max_entries) {
+        std::filesystem::create_directories(_dir);
+        evict();
+    }
+
+    const std::filesystem::path &dir() const { return _dir; }
+
+    std::optional<answers> lookup(const solution &s, std::string_view text) const {
+        const auto path = entry(s, text);
+        std::ifstream in(path, std::ios::binary);
+        std::string head;
+        size_t n1 = 0, n2 = 0;
+        if (!std::getline(in, head) || head != header(s, text) || !(in >> n1 >> n2)
+            || in.get() != '\n') {
+            return std::nullopt;
+        }
+        answers a;
+        a.part1.resize(n1);
+        a.part2.resize(n2);
+        if (!in.read(a.part1.data(), n1) || !in.read(a.part2.data(), n2)
+            || in.peek() != std::ifstream::traits_type::eof()) {
+            return std::nullopt;
+        }
+        touch(path);
+        return a;
+    }
+
+    void store(const solution &s, std::string_view text, const answers &a) const {
+        const auto path = entry(s, text);
+        // Unique to this thread of this process, which only writes one at a time.
+        const auto tid = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        const auto tmp
+            = _dir / fmt::format(".{}.{}.{:x}", path.filename().string(), ::getpid(), tid);
+        std::error_code ec;
+        uintmax_t size = 0;
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            out << header(s, text) << '\n' << a.part1.size() << ' ' << a.part2.size() << '\n';
+            out << a.part1 << a.part2;
+            size = out.tellp();
+            out.close();
+            if (!out) {
+                ec = std::make_error_code(std::errc::io_error);
+            }
+        }
+        if (!ec) {
+            std::filesystem::rename(tmp, path, ec);
+        }
+        if (ec) {
+            spdlog::warn("answer cache: can't store {}: {}", path.string(), ec.message());
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+        touch(path);
+        // Replacing an entry counts it twice, which the next scan puts right.
+        const auto bytes = _bytes += size;
+        const auto entries = ++_entries;
+        if (bytes > _max_bytes || entries > _max_entries) {
+            evict();
+        }
+    }
+};
+
+// solve(s, text), or the answers cache already has for it; new ones are
+// stored there. A null cache just solves.
+inline answers solve(const solution &s, std::string_view text, const answer_cache *cache) {
+    if (!cache) {
+        return solve(s, text);
+    }
+    {
+        scoped_timer t("cache");
+        AOC_TRACE_SPAN("cache");
+        if (auto a = cache->lookup(s, text)) {
+            return std::move(*a);
+        }
+    }
+    auto a = solve(s, text);
+    cache->store(s, text, a);
+    return a;
+}
+
+} // namespace prelude
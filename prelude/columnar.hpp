@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "prelude/soa.hpp"
+
+// A parsed input saved as columns of numbers, so a later run loads it with a
+// memcpy a column instead of parsing the text all over again. Columns come
+// back in the order they went in, each checked against the type it's read as:
+//
+//     void save(const Inventory &inv, prelude::column_writer &out) {
+//         out.soa(inv.ranges);
+//         out.column(inv.ids);
+//     }
+//     Inventory load(prelude::column_reader &in) {
+//         auto ranges = in.soa<long, long>();
+//         auto ids = in.column<long>();
+//         return {std::move(ranges), std::vector<long>(ids.begin(), ids.end())};
+//     }
+//
+// soa() saves a soa_vector a field to a column, and ragged() a vector of
+// vectors as two columns: where each row ends, and all the rows end to end.
+// column() hands back a span into the file; soa() and ragged() copy out.
+//
+// The file is a header (magic, format version, year, day and the day's
+// version), a table of the columns (element type, count, offset), then the
+// columns, each 64-byte aligned so a mapped file can be read in place.
+// Little-endian only. A file saved by another version of the day is refused,
+// so a day bumps AOC_SOLUTION_VERSION when what it saves changes. See aoc.hpp
+// for how a day hooks these up.
+
+namespace prelude {
+
+static_assert(std::endian::native == std::endian::little);
+
+namespace detail {
+inline constexpr std::string_view columnar_magic{"aoc-col\n", 8};
+inline constexpr uint32_t columnar_format = 1;
+inline constexpr size_t columnar_align = 64;
+
+struct columnar_header {
+    char magic[8];
+    uint32_t format;
+    uint32_t year;
+    uint32_t day;
+    uint32_t version;
+    uint64_t columns;
+};
+
+struct columnar_column {
+    uint32_t type;
+    uint32_t unused;
+    uint64_t count;
+    uint64_t offset;
+};
+
+// 'i', 'u' or 'f', then the size in bytes: "i8" is a long.
+template <typename T> constexpr uint32_t column_type() {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "columns are of numbers (use uint8_t for bools)");
+    const char kind = std::is_floating_point_v<T> ? 'f' : std::is_signed_v<T> ? 'i' : 'u';
+    return static_cast<uint32_t>(kind) << 8 | sizeof(T);
+}
+
+inline std::string column_type_name(uint32_t type) {
+    return fmt::format("{}{}", static_cast<char>(type >> 8), type & 0xff);
+}
+} // namespace detail
+
+inline bool is_columnar(std::string_view data) {
+    return data.starts_with(detail::columnar_magic);
+}
+
+class column_writer {
+    struct column_data {
+        uint32_t type;
+        uint64_t count;
+        std::string bytes;
+    };
+    std::vector<column_data> _columns;
+
+  public:
+    template <std::ranges::contiguous_range R>
+        requires std::ranges::sized_range<R>
+    void column(R &&r) {
+        using T = std::remove_cv_t<std::ranges::range_value_t<R>>;
+        const auto *p = reinterpret_cast<const char *>(std::ranges::data(r));
+        const size_t n = std::ranges::size(r);
+        _columns.push_back({detail::column_type<T>(), n, std::string(p, n * sizeof(T))});
+    }
+
+    template <typename T> void value(T x) { column(std::span<const T>(&x, 1)); }
+
+    template <typename... Ts> void soa(const soa_vector<Ts...> &v) {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (column(v.template field<I>()), ...);
+        }(std::index_sequence_for<Ts...>{});
+    }
+
+    template <std::ranges::input_range R> void ragged(R &&rows) {
+        using Row = std::ranges::range_reference_t<R>;
+        using T = std::remove_cvref_t<std::ranges::range_reference_t<Row>>;
+        std::vector<uint64_t> ends;
+        std::vector<T> flat;
+        for (auto &&row : rows) {
+            flat.insert(flat.end(), std::ranges::begin(row), std::ranges::end(row));
+            ends.push_back(flat.size());
+        }
+        column(ends);
+        column(flat);
+    }
+
+    // The file, for the given day at the given version.
+    std::string bytes(int year, int day, int version) const {
+        detail::columnar_header header{};
+        std::memcpy(header.magic, detail::columnar_magic.data(), sizeof(header.magic));
+        header.format = detail::columnar_format;
+        header.year = year;
+        header.day = day;
+        header.version = version;
+        header.columns = _columns.size();
+
+        auto aligned = [](size_t n) {
+            return (n + detail::columnar_align - 1) / detail::columnar_align
+                   * detail::columnar_align;
+        };
+        std::vector<detail::columnar_column> table;
+        size_t at = aligned(sizeof(header) + _columns.size() * sizeof(detail::columnar_column));
+        for (const auto &c : _columns) {
+            table.push_back({c.type, 0, c.count, at});
+            at = aligned(at + c.bytes.size());
+        }
+
+        std::string out(at, '\0');
+        std::memcpy(out.data(), &header, sizeof(header));
+        std::memcpy(out.data() + sizeof(header), table.data(),
+                    table.size() * sizeof(detail::columnar_column));
+        for (size_t i = 0; i < _columns.size(); ++i) {
+            std::memcpy(out.data() + table[i].offset, _columns[i].bytes.data(),
+                        _columns[i].bytes.size());
+        }
+        return out;
+    }
+};
+
+// Reads a file from column_writer, in place: the spans point into data, so it
+// has to outlive them. Throws std::runtime_error if the file is for another
+// day or version, is cut short, or holds something other than what's asked.
+class column_reader {
+    std::string_view _data;
+    uint64_t _columns = 0;
+    uint64_t _next = 0;
+
+    [[noreturn]] static void fail(const std::string &why) {
+        throw std::runtime_error("columnar input: " + why);
+    }
+
+  public:
+    column_reader(std::string_view data, int year, int day, int version) : _data(data) {
+        detail::columnar_header header;
+        if (!is_columnar(data) || data.size() < sizeof(header)) {
+            fail("no header");
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.format != detail::columnar_format) {
+            fail(fmt::format("format {}, not {}", header.format, detail::columnar_format));
+        }
+        if (header.year != static_cast<uint32_t>(year) || header.day != static_cast<uint32_t>(day)
+            || header.version != static_cast<uint32_t>(version)) {
+            fail(fmt::format("saved by {}/day{} v{}, not {}/day{} v{}", header.year, header.day,
+                             header.version, year, day, version));
+        }
+        if (header.columns > (data.size() - sizeof(header)) / sizeof(detail::columnar_column)) {
+            fail("column table cut short");
+        }
+        _columns = header.columns;
+    }
+
+    // The next column, as Ts.
+    template <typename T> std::span<const T> column() {
+        if (_next == _columns) {
+            fail("no more columns");
+        }
+        detail::columnar_column c;
+        std::memcpy(&c,
+                    _data.data() + sizeof(detail::columnar_header)
+                        + _next * sizeof(detail::columnar_column),
+                    sizeof(c));
+        if (c.type != detail::column_type<T>()) {
+            fail(fmt::format("column {} holds {}, not {}", _next, detail::column_type_name(c.type),
+                             detail::column_type_name(detail::column_type<T>())));
+        }
+        if (c.offset > _data.size() || c.count > (_data.size() - c.offset) / sizeof(T)) {
+            fail(fmt::format("column {} cut short", _next));
+        }
+        const char *p = _data.data() + c.offset;
+        if (reinterpret_cast<uintptr_t>(p) % alignof(T) != 0) {
+            fail("misaligned");
+        }
+        ++_next;
+        return {reinterpret_cast<const T *>(p), c.count};
+    }
+
+    template <typename T> T value() {
+        auto c = column<T>();
+        if (c.size() != 1) {
+            fail(fmt::format("column {} isn't one value", _next - 1));
+        }
+        return c[0];
+    }
+
+    // A soa() column per field, copied out.
+    template <typename... Ts> soa_vector<Ts...> soa() {
+        // Braces, so the columns are read in order.
+        std::tuple<std::span<const Ts>...> fields{column<Ts>()...};
+        const size_t n = std::get<0>(fields).size();
+        if (!std::apply([n](const auto &...f) { return ((f.size() == n) && ...); }, fields)) {
+            fail("soa columns of different lengths");
+        }
+        soa_vector<Ts...> v(n);
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (std::ranges::copy(std::get<I>(fields), v.template field<I>().begin()), ...);
+        }(std::index_sequence_for<Ts...>{});
+        return v;
+    }
+
+    // The rows of a ragged() column pair.
+    template <typename T> std::vector<std::span<const T>> ragged() {
+        auto ends = column<uint64_t>();
+        auto flat = column<T>();
+        std::vector<std::span<const T>> rows;
+        rows.reserve(ends.size());
+        uint64_t begin = 0;
+        for (uint64_t end : ends) {
+            if (end < begin || end > flat.size()) {
+                fail("ragged column out of order");
+            }
+            rows.push_back(flat.subspan(begin, end - begin));
+            begin = end;
+        }
+        return rows;
+    }
+};
+
+} // namespace prelude
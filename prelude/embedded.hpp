@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "prelude/input.hpp"
+
+// An input built into the binary, for a day's _fixture target (see aoc() in
+// bzl/aoc.bzl). Compiled with AOC_EMBEDDED_INPUT naming a file that holds the
+// input as a string literal, a day has it as embedded_input, a constexpr
+// string_view, and can parse some or all of it at compile time with lines(),
+// map_lines() and ints():
+//
+//     #ifdef AOC_EMBEDDED_INPUT
+//     constexpr auto packages
+//         = prelude::map_lines<prelude::embedded_lines>(prelude::embedded_input, fromString);
+//     Packages embedded() { return Packages(packages); }
+//     AOC_SOLUTION_EMBEDDED(2015, 2, embedded);
+//     #endif
+//
+// See aoc.hpp for AOC_SOLUTION_EMBEDDED. The compiler caps how much it will
+// evaluate (-fconstexpr-ops-limit, -fconstexpr-loop-limit), so this is for
+// fixture-sized inputs, not generated megabytes.
+//
+// embedded_text() is the same input at run time, for embedded_main.cpp to
+// parse when the day has no AOC_SOLUTION_EMBEDDED. It's empty in builds
+// without one.
+
+namespace prelude {
+
+inline std::string_view &embedded_text() {
+    static std::string_view text;
+    return text;
+}
+
+#ifdef AOC_EMBEDDED_INPUT
+namespace detail {
+inline constexpr char embedded_bytes[] =
+#include AOC_EMBEDDED_INPUT
+    ;
+
+inline const bool embedded_text_set
+    = (embedded_text() = std::string_view(embedded_bytes, sizeof(embedded_bytes) - 1), true);
+} // namespace detail
+
+inline constexpr std::string_view embedded_input{detail::embedded_bytes,
+                                                 sizeof(detail::embedded_bytes) - 1};
+inline constexpr size_t embedded_lines = line_count(embedded_input);
+#endif
+
+} // namespace prelude
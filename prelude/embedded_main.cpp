@@ -0,0 +1,65 @@
+// main() for a day's _fixture binary, which has its input compiled in
+// (embedded.hpp) and takes none:
+//
+//     dayN_fixture [--timing=PATH]
+//
+// A day with AOC_SOLUTION_EMBEDDED starts from what it parsed at compile
+// time, under an "embedded" timer in place of "parse"; any other day parses
+// the built-in text as usual. --timing (or $AOC_TIMING) is as for main.cpp.
+
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#include "prelude/aoc.hpp"
+#include "prelude/embedded.hpp"
+#include "prelude/timing.hpp"
+#include "prelude/trace.hpp"
+
+int main(int argc, char **argv) {
+    auto &solutions = prelude::registry();
+    if (solutions.size() != 1) {
+        spdlog::error("expected exactly one registered solution, found {}", solutions.size());
+        return 1;
+    }
+    const auto &solution = solutions.front();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--timing=")) {
+            prelude::timing().enable(std::string(arg.substr(9)));
+        } else {
+            spdlog::error("usage: {} [--timing=PATH]", argv[0]);
+            return 1;
+        }
+    }
+
+    auto &timing = prelude::timing();
+    timing.annotate("solution", solution.name());
+    timing.annotate("input", "embedded");
+    timing.annotate("input_bytes", static_cast<long>(prelude::embedded_text().size()));
+
+    try {
+        std::shared_ptr<const void> input;
+        if (solution.embedded) {
+            prelude::scoped_timer t("embedded");
+            AOC_TRACE_SPAN("embedded");
+            input = solution.embedded();
+        } else {
+            input = prelude::parse_input(solution, prelude::embedded_text());
+        }
+        auto answers = prelude::solve_parsed(solution, input.get());
+        fmt::print("part 1: {}\n", answers.part1);
+        if (solution.part2) {
+            fmt::print("part 2: {}\n", answers.part2);
+        }
+    } catch (const std::exception &e) {
+        spdlog::error("{}: {}", solution.name(), e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+// Support for the dayN_gen binaries, which write a synthetic puzzle input of
+// whatever size you ask for to stdout, so the days can be run (and
+// benchmarked) well past the size of a real input:
+//
+//     void generate(prelude::gen_args &args, prelude::gen_out &out) {
+//         const long n = args.get("n", 1000l, "number of points");
+//         prelude::rng rng(args.seed());
+//         args.done();
+//         for (long i = 0; i < n; ++i) {
+//             out.print("{},{}\n", rng.uniform(0, 99), rng.uniform(0, 99));
+//         }
+//     }
+//
+//     int main(int argc, char **argv) {
+//         return prelude::gen_main(argc, argv, "N points.", generate);
+//     }
+//
+// Options are --name=value. The same seed gives the same input everywhere.
+
+namespace prelude {
+
+// splitmix64. <random>'s engines are portable but its distributions aren't,
+// so the helpers here do their own range reduction and a seed names the
+// same input whichever standard library built the generator.
+class rng {
+    uint64_t _state;
+
+  public:
+    explicit rng(uint64_t seed) : _state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (_state += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [lo, hi], both ends included.
+    template <std::integral T> T uniform(T lo, T hi) {
+        if (hi < lo) {
+            throw std::invalid_argument(fmt::format("empty range [{}, {}]", lo, hi));
+        }
+        using U = std::make_unsigned_t<T>;
+        const uint64_t span = static_cast<uint64_t>(static_cast<U>(hi) - static_cast<U>(lo));
+        if (span == UINT64_MAX) {
+            return static_cast<T>(next());
+        }
+        // Lemire's multiply-and-reject: no modulo bias, rarely loops.
+        const uint64_t range = span + 1;
+        const uint64_t threshold = -range % range;
+        while (true) {
+            const unsigned __int128 m = static_cast<unsigned __int128>(next()) * range;
+            if (static_cast<uint64_t>(m) >= threshold) {
+                return static_cast<T>(static_cast<U>(lo) + static_cast<U>(m >> 64));
+            }
+        }
+    }
+
+    // Uniform in [0, 1).
+    double real() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    bool chance(double p) { return real() < p; }
+
+    template <typename R> decltype(auto) pick(R &&r) {
+        return r[uniform<size_t>(0, std::size(r) - 1)];
+    }
+
+    template <typename T> void shuffle(std::vector<T> &v) {
+        for (size_t i = v.size(); i > 1; --i) {
+            std::swap(v[i - 1], v[uniform<size_t>(0, i - 1)]);
+        }
+    }
+};
+
+// The --name=value command line of a generator. Every option is declared by
+// a get() with its default and a line of help; done() then rejects anything
+// that wasn't declared, and answers --help with the list.
+class gen_args {
+    std::string _prog;
+    std::string _about;
+    std::map<std::string, std::string, std::less<>> _given;
+    std::vector<std::string> _known;
+    std::string _options;
+    std::string _error; // the first bad option, reported by done()
+    bool _help = false;
+
+  public:
+    // Thrown for --help and for bad command lines; gen_main prints it.
+    struct usage {
+        int status;
+        std::string text;
+    };
+
+    gen_args(int argc, char **argv, std::string about) : _prog(argv[0]), _about(std::move(about)) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                _help = true;
+                continue;
+            }
+            const auto eq = arg.find('=');
+            if (!arg.starts_with("--") || eq == std::string_view::npos) {
+                reject(fmt::format("expected --name=value, got '{}'", arg));
+                continue;
+            }
+            _given.emplace(arg.substr(2, eq - 2), arg.substr(eq + 1));
+        }
+    }
+
+    template <typename T> T get(std::string_view name, T fallback, std::string_view help) {
+        _known.emplace_back(name);
+        _options += fmt::format("  --{}={}\n      {}\n", name, fallback, help);
+        auto found = _given.find(name);
+        if (found == _given.end()) {
+            return fallback;
+        }
+        const std::string &s = found->second;
+        T value{};
+        if constexpr (std::is_floating_point_v<T>) {
+            // from_chars for doubles is still missing from some libc++ versions
+            char *end = nullptr;
+            value = static_cast<T>(std::strtod(s.c_str(), &end));
+            if (s.empty() || *end != '\0') {
+                reject(fmt::format("--{}: '{}' is not a number", name, s));
+                return fallback;
+            }
+        } else {
+            auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+            if (ec != std::errc{} || end != s.data() + s.size()) {
+                reject(fmt::format("--{}: '{}' is not a number", name, s));
+                return fallback;
+            }
+        }
+        return value;
+    }
+
+    uint64_t seed() { return get<uint64_t>("seed", 1, "random seed"); }
+
+    // Call once every option has been read.
+    void done() {
+        if (_help) {
+            throw usage{0, text()};
+        }
+        for (const auto &[name, value] : _given) {
+            if (std::find(_known.begin(), _known.end(), name) == _known.end()) {
+                reject(fmt::format("unknown option --{}", name));
+            }
+        }
+        if (!_error.empty()) {
+            fail(_error);
+        }
+    }
+
+    // For option values that parse but make no sense together.
+    void check(bool ok, std::string_view message) {
+        if (!ok) {
+            fail(message);
+        }
+    }
+
+    [[noreturn]] void fail(std::string_view message) {
+        throw usage{2, fmt::format("{}: {}\n\n{}", _prog, message, text())};
+    }
+
+  private:
+    void reject(std::string message) {
+        if (_error.empty()) {
+            _error = std::move(message);
+        }
+    }
+
+    std::string text() const {
+        return fmt::format("usage: {} [--name=value ...] > input.txt\n\n{}\n\noptions:\n{}", _prog,
+                           _about, _options);
+    }
+};
+
+// stdout through a big buffer: a generated input can run to gigabytes.
+class gen_out {
+    fmt::memory_buffer _buf;
+
+  public:
+    gen_out() = default;
+    gen_out(const gen_out &) = delete;
+    gen_out &operator=(const gen_out &) = delete;
+    ~gen_out() { flush(); }
+
+    template <typename... Args> void print(fmt::format_string<Args...> fmt, Args &&...args) {
+        fmt::format_to(std::back_inserter(_buf), fmt, std::forward<Args>(args)...);
+        if (_buf.size() >= (1 << 20)) {
+            flush();
+        }
+    }
+
+    void put(char ch) {
+        _buf.push_back(ch);
+        if (_buf.size() >= (1 << 20)) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (_buf.size() > 0) {
+            std::fwrite(_buf.data(), 1, _buf.size(), stdout);
+            _buf.clear();
+        }
+        std::fflush(stdout);
+    }
+};
+
+// main() for a generator: generate(args, out) declares its options on args,
+// calls args.done(), then writes the input to out.
+template <typename F> int gen_main(int argc, char **argv, std::string about, F generate) {
+    try {
+        gen_args args(argc, argv, std::move(about));
+        gen_out out;
+        generate(args, out);
+        return 0;
+    } catch (const gen_args::usage &u) {
+        std::fputs(u.text.c_str(), u.status == 0 ? stdout : stderr);
+        return u.status;
+    } catch (const std::exception &e) {
+        fmt::print(stderr, "{}: {}\n", argv[0], e.what());
+        return 1;
+    }
+}
+
+} // namespace prelude
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/core.h>
+
+namespace prelude {
+
+// A rows x cols grid stored row-major in one contiguous block, optionally
+// surrounded by a halo of `pad` extra cells on every side filled with a
+// background value. Coordinates are always for the interior, so with pad >= 1
+// (r ± 1, c ± 1) is valid for every interior cell and the neighbor helpers
+// need no bounds checks at all.
+//
+// No Grid<bool>: std::vector<bool> isn't contiguous. Use char or uint8_t.
+//
+// The cells come from Alloc, so prelude::pmr::Grid<T> can live in an arena.
+template <typename T, typename Alloc = std::allocator<T>> class Grid {
+    static_assert(!std::is_same_v<T, bool>, "use Grid<char> or Grid<uint8_t> instead of bool");
+
+    std::vector<T, Alloc> _cells;
+    int _rows = 0, _cols = 0, _pad = 0;
+    std::ptrdiff_t _stride = 0;
+
+    std::ptrdiff_t index(int r, int c) const {
+        assert(r >= -_pad && r < _rows + _pad);
+        assert(c >= -_pad && c < _cols + _pad);
+        return (r + _pad) * _stride + (c + _pad);
+    }
+
+  public:
+    Grid() = default;
+    explicit Grid(const Alloc &alloc) : _cells(alloc) {}
+    Grid(int rows, int cols, int pad = 0, const T &fill = T{}, const Alloc &alloc = Alloc{})
+        : _cells(static_cast<size_t>(rows + 2 * pad) * (cols + 2 * pad), fill, alloc),
+          _rows(rows), _cols(cols), _pad(pad), _stride(cols + 2 * pad) {}
+
+    // One row per line, each char mapped through f. Works on single-pass
+    // ranges like line_view; every line has to be the same length.
+    template <std::ranges::input_range R, typename F>
+    static Grid from_lines(R &&lines, F f, int pad = 0, const T &fill = T{},
+                           const Alloc &alloc = Alloc{}) {
+        Grid g(alloc);
+        g._pad = pad;
+        for (auto &&line : lines) {
+            std::string_view sv(line);
+            if (g._rows == 0) {
+                g._cols = static_cast<int>(sv.size());
+                g._stride = g._cols + 2 * pad;
+                g._cells.assign(static_cast<size_t>(pad * g._stride), fill);
+            } else if (static_cast<int>(sv.size()) != g._cols) {
+                throw std::invalid_argument(
+                    fmt::format("ragged grid: row {} has {} columns, expected {}", g._rows,
+                                sv.size(), g._cols));
+            }
+            g._cells.insert(g._cells.end(), pad, fill);
+            for (char ch : sv) {
+                g._cells.push_back(f(ch));
+            }
+            g._cells.insert(g._cells.end(), pad, fill);
+            ++g._rows;
+        }
+        g._cells.insert(g._cells.end(), static_cast<size_t>(pad * g._stride), fill);
+        return g;
+    }
+
+    int rows() const { return _rows; }
+    int cols() const { return _cols; }
+    int pad() const { return _pad; }
+
+    // Distance between vertically adjacent cells, for kernels that walk the
+    // raw cells (&g(r, c) + stride() is &g(r + 1, c)).
+    std::ptrdiff_t stride() const { return _stride; }
+
+    T &operator()(int r, int c) { return _cells[index(r, c)]; }
+    const T &operator()(int r, int c) const { return _cells[index(r, c)]; }
+
+    T get(int r, int c) const { return (*this)(r, c); }
+    void set(int r, int c, const T &x) { (*this)(r, c) = x; }
+
+    // Interior cells of one row.
+    std::span<T> row(int r) { return {&(*this)(r, 0), static_cast<size_t>(_cols)}; }
+    std::span<const T> row(int r) const { return {&(*this)(r, 0), static_cast<size_t>(_cols)}; }
+
+    // Every interior cell, row by row.
+    auto cells() const {
+        return std::views::iota(0, _rows)
+               | std::views::transform([this](int r) { return row(r); }) | std::views::join;
+    }
+
+    // The 8 surrounding cells, as straight-line loads. Needs pad >= 1.
+    std::array<T, 8> neighbors(int r, int c) const {
+        assert(_pad >= 1);
+        const T *p = &(*this)(r, c);
+        const std::ptrdiff_t s = _stride;
+        return {p[-s - 1], p[-s], p[-s + 1], p[-1], p[1], p[s - 1], p[s], p[s + 1]};
+    }
+
+    // Sum of the 8 surrounding cells. Needs pad >= 1.
+    template <typename U = T> U neighbor_sum(int r, int c) const {
+        assert(_pad >= 1);
+        const T *p = &(*this)(r, c);
+        const std::ptrdiff_t s = _stride;
+        return U(p[-s - 1]) + U(p[-s]) + U(p[-s + 1]) + U(p[-1]) + U(p[1]) + U(p[s - 1]) + U(p[s])
+               + U(p[s + 1]);
+    }
+
+    // How many of the 8 surrounding cells equal x. Needs pad >= 1.
+    int count_neighbors(int r, int c, const T &x) const {
+        assert(_pad >= 1);
+        const T *p = &(*this)(r, c);
+        const std::ptrdiff_t s = _stride;
+        return (p[-s - 1] == x) + (p[-s] == x) + (p[-s + 1] == x) + (p[-1] == x) + (p[1] == x)
+               + (p[s - 1] == x) + (p[s] == x) + (p[s + 1] == x);
+    }
+
+    // out(r, c) = f(r, c, *this) for every interior cell: a whole-grid
+    // stencil pass into a grid of the same shape.
+    template <typename F> auto stencil(F f) const {
+        using U = std::decay_t<std::invoke_result_t<F &, int, int, const Grid &>>;
+        Grid<U> out(_rows, _cols, _pad);
+        for (int r = 0; r < _rows; ++r) {
+            for (int c = 0; c < _cols; ++c) {
+                out(r, c) = f(r, c, *this);
+            }
+        }
+        return out;
+    }
+};
+
+namespace pmr {
+template <typename T> using Grid = prelude::Grid<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+} // namespace prelude
+
+template <typename T, typename A>
+struct fmt::formatter<prelude::Grid<T, A>> : fmt::formatter<std::string_view> {
+    auto format(const prelude::Grid<T, A> &g, fmt::format_context &ctx) const {
+        std::string s;
+        s.reserve((1 + g.cols()) * g.rows());
+        for (int r = 0; r < g.rows(); ++r) {
+            for (const auto &x : g.row(r)) {
+                s.append(fmt::format("{}", x));
+            }
+            s.push_back('\n');
+        }
+        return fmt::formatter<std::string_view>::format(s, ctx);
+    }
+};
@@ -0,0 +1,386 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Flat hash containers for lookups on hot paths, where std::set and std::map
+// chase a pointer per level and ordering is never needed.
+//
+// flat_map and flat_set keep their entries packed in one std::vector (so
+// iterating is a linear walk, in no particular order) and find them through
+// an open-addressed index of 8-byte buckets, robin-hood probed. A lookup is
+// usually one cache miss for the bucket and one for the entry. Erasing moves
+// the last entry into the hole, so it invalidates iterators and references,
+// as does any insertion that grows the table. Map entries are
+// std::pair<Key, Mapped>; don't change a key through an iterator.
+//
+// prelude::hash is the default hasher:
+//  - integers, enums and pointers get a multiply-xorshift mix;
+//  - small aggregates with no padding (struct coord { int x, y; }) are hashed
+//    as their bytes;
+//  - strings are hashed through string_view, and are transparent, so a
+//    flat_map<std::string, V> can be searched with a string_view;
+//  - pairs, tuples and arrays hash their elements;
+//  - anything else can provide hash_value(const T &) next to itself (use
+//    hash_fields for the members), and falls back to std::hash.
+
+namespace prelude {
+
+namespace detail {
+inline constexpr uint64_t hash_k0 = 0x9e3779b97f4a7c15;
+inline constexpr uint64_t hash_k1 = 0xe7037ed1a0b428db;
+
+// 64x64 -> 128 bit multiply, folded: the wyhash mixer.
+constexpr uint64_t hash_mix(uint64_t a, uint64_t b) {
+    const __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+inline uint64_t hash_bytes(const void *data, size_t n, uint64_t seed = hash_k0) {
+    const auto *p = static_cast<const unsigned char *>(data);
+    uint64_t h = seed ^ n;
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t w;
+        std::memcpy(&w, p, 8);
+        h = hash_mix(h ^ w, hash_k1);
+    }
+    uint64_t w = 0;
+    std::memcpy(&w, p, n);
+    return hash_mix(h ^ w, hash_k1);
+}
+
+template <typename T>
+concept tuple_like = requires { std::tuple_size<T>::value; };
+
+// What lookups take: any Q at all if the hasher and the comparison are both
+// transparent, otherwise the key type itself (so arguments convert to it).
+template <bool transparent> struct key_arg {
+    template <typename Q, typename Key> using type = Key;
+};
+template <> struct key_arg<true> {
+    template <typename Q, typename Key> using type = Q;
+};
+} // namespace detail
+
+template <typename T> struct hash;
+
+// One hash of several values, for writing hash_value:
+//
+//     friend size_t hash_value(const key &k) { return prelude::hash_fields(k.n, k.dac); }
+template <typename... A> size_t hash_fields(const A &...a) {
+    uint64_t h = detail::hash_k0;
+    ((h = detail::hash_mix(h ^ hash<A>{}(a), detail::hash_k1)), ...);
+    return h;
+}
+
+template <typename T> struct hash {
+    size_t operator()(const T &x) const {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            return detail::hash_mix(static_cast<uint64_t>(x), detail::hash_k0);
+        } else if constexpr (std::is_pointer_v<T>) {
+            return detail::hash_mix(reinterpret_cast<uintptr_t>(x), detail::hash_k0);
+        } else if constexpr (requires { hash_value(x); }) {
+            return hash_value(x);
+        } else if constexpr (std::has_unique_object_representations_v<T>) {
+            return detail::hash_bytes(&x, sizeof(x));
+        } else if constexpr (detail::tuple_like<T>) {
+            return std::apply([](const auto &...a) { return hash_fields(a...); }, x);
+        } else {
+            return detail::hash_mix(std::hash<T>{}(x), detail::hash_k0);
+        }
+    }
+};
+
+// Strings of every flavour hash alike, so lookups can mix them.
+struct string_hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const { return detail::hash_bytes(s.data(), s.size()); }
+};
+template <> struct hash<std::string> : string_hash {};
+template <> struct hash<std::string_view> : string_hash {};
+
+namespace detail {
+template <typename Key, typename Mapped, typename Hash, typename Eq> class flat_table {
+  public:
+    using key_type = Key;
+    using value_type = std::conditional_t<std::is_void_v<Mapped>, Key, std::pair<Key, Mapped>>;
+    using size_type = size_t;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+  private:
+    // dist_fp is the probe distance + 1 in the high 24 bits over 8 bits of
+    // the hash; 0 means empty. Comparing whole words orders by distance
+    // first, which is what robin hood wants.
+    struct bucket {
+        uint32_t dist_fp = 0;
+        uint32_t index = 0;
+    };
+    static constexpr uint32_t dist_one = 1 << 8;
+
+    std::vector<value_type> _values;
+    std::vector<bucket> _buckets;
+    int _shift = 64; // bucket = hash >> _shift
+    [[no_unique_address]] Hash _hash;
+    [[no_unique_address]] Eq _eq;
+
+    static constexpr bool transparent
+        = requires { typename Hash::is_transparent; } && requires { typename Eq::is_transparent; };
+    template <typename Q> using lookup_key = typename key_arg<transparent>::template type<Q, Key>;
+
+    static const Key &key_of(const value_type &v) {
+        if constexpr (std::is_void_v<Mapped>) {
+            return v;
+        } else {
+            return v.first;
+        }
+    }
+
+    size_t mask() const { return _buckets.size() - 1; }
+
+    uint32_t dist_fp_of(uint64_t h) const { return dist_one | static_cast<uint32_t>(h & 0xff); }
+    size_t home(uint64_t h) const { return _shift == 64 ? 0 : h >> _shift; }
+
+    // The bucket holding key, or the one where it would go (with dist_fp
+    // the entry it would need there) if it isn't in the table.
+    template <typename Q> std::pair<size_t, uint32_t> probe(const Q &key, bool &found) const {
+        const uint64_t h = _hash(key);
+        uint32_t dfp = dist_fp_of(h);
+        size_t i = home(h);
+        found = false;
+        if (_buckets.empty()) {
+            return {0, dfp};
+        }
+        while (dfp <= _buckets[i].dist_fp) {
+            if (dfp == _buckets[i].dist_fp && _eq(key_of(_values[_buckets[i].index]), key)) {
+                found = true;
+                return {i, dfp};
+            }
+            dfp += dist_one;
+            i = (i + 1) & mask();
+        }
+        return {i, dfp};
+    }
+
+    // Puts b at i, pushing richer entries further along.
+    void place(bucket b, size_t i) {
+        while (_buckets[i].dist_fp != 0) {
+            std::swap(b, _buckets[i]);
+            b.dist_fp += dist_one;
+            i = (i + 1) & mask();
+        }
+        _buckets[i] = b;
+    }
+
+    void rebuild(size_t n_buckets) {
+        _buckets.assign(n_buckets, bucket{});
+        _shift = 64 - std::countr_zero(n_buckets);
+        for (uint32_t idx = 0; idx < _values.size(); ++idx) {
+            const uint64_t h = _hash(key_of(_values[idx]));
+            uint32_t dfp = dist_fp_of(h);
+            size_t i = home(h);
+            while (dfp <= _buckets[i].dist_fp) {
+                dfp += dist_one;
+                i = (i + 1) & mask();
+            }
+            place({dfp, idx}, i);
+        }
+    }
+
+    // At most 80% of the buckets in use.
+    static bool too_full(size_t n, size_t n_buckets) { return n * 5 > n_buckets * 4; }
+
+    void grow_for(size_t n) {
+        if (!too_full(n, _buckets.size())) {
+            return;
+        }
+        size_t want = std::max<size_t>(8, _buckets.size());
+        while (too_full(n, want)) {
+            want *= 2;
+        }
+        rebuild(want);
+    }
+
+    template <typename Q, typename... A> std::pair<iterator, bool> emplace_key(Q &&key, A &&...a) {
+        if constexpr (!transparent && !std::is_same_v<std::remove_cvref_t<Q>, Key>) {
+            return emplace_key(Key(std::forward<Q>(key)), std::forward<A>(a)...);
+        } else {
+            bool found;
+            auto [i, dfp] = probe(key, found);
+            if (found) {
+                return {_values.begin() + _buckets[i].index, false};
+            }
+            if (too_full(_values.size() + 1, _buckets.size())) {
+                grow_for(_values.size() + 1);
+                std::tie(i, dfp) = probe(key, found);
+            }
+            const auto idx = static_cast<uint32_t>(_values.size());
+            if constexpr (std::is_void_v<Mapped>) {
+                _values.emplace_back(std::forward<Q>(key));
+            } else {
+                _values.emplace_back(std::piecewise_construct,
+                                     std::forward_as_tuple(std::forward<Q>(key)),
+                                     std::forward_as_tuple(std::forward<A>(a)...));
+            }
+            place({dfp, idx}, i);
+            return {_values.end() - 1, true};
+        }
+    }
+
+  public:
+    flat_table() = default;
+
+    template <std::input_iterator It, std::sentinel_for<It> S> flat_table(It first, S last) {
+        if constexpr (std::sized_sentinel_for<S, It>) {
+            reserve(static_cast<size_t>(last - first));
+        }
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    flat_table(std::initializer_list<value_type> init) : flat_table(init.begin(), init.end()) {}
+
+    iterator begin() { return _values.begin(); }
+    iterator end() { return _values.end(); }
+    const_iterator begin() const { return _values.begin(); }
+    const_iterator end() const { return _values.end(); }
+
+    size_t size() const { return _values.size(); }
+    bool empty() const { return _values.empty(); }
+
+    void clear() {
+        _values.clear();
+        std::fill(_buckets.begin(), _buckets.end(), bucket{});
+    }
+
+    // Room for n entries without growing.
+    void reserve(size_t n) {
+        _values.reserve(n);
+        grow_for(n);
+    }
+
+    template <typename Q = Key> iterator find(const lookup_key<Q> &key) {
+        bool found;
+        const size_t i = probe(key, found).first;
+        return found ? _values.begin() + _buckets[i].index : _values.end();
+    }
+
+    template <typename Q = Key> const_iterator find(const lookup_key<Q> &key) const {
+        bool found;
+        const size_t i = probe(key, found).first;
+        return found ? _values.begin() + _buckets[i].index : _values.end();
+    }
+
+    template <typename Q = Key> bool contains(const lookup_key<Q> &key) const {
+        bool found;
+        probe(key, found);
+        return found;
+    }
+
+    template <typename Q = Key> size_t count(const lookup_key<Q> &key) const {
+        return contains<Q>(key) ? 1 : 0;
+    }
+
+    std::pair<iterator, bool> insert(const value_type &v) {
+        if constexpr (std::is_void_v<Mapped>) {
+            return emplace_key(v);
+        } else {
+            return emplace_key(v.first, v.second);
+        }
+    }
+
+    std::pair<iterator, bool> insert(value_type &&v) {
+        if constexpr (std::is_void_v<Mapped>) {
+            return emplace_key(std::move(v));
+        } else {
+            return emplace_key(std::move(v.first), std::move(v.second));
+        }
+    }
+
+    template <typename... A> std::pair<iterator, bool> emplace(A &&...a) {
+        return insert(value_type(std::forward<A>(a)...));
+    }
+
+    // Constructs the mapped value from a only if key isn't there yet.
+    template <typename Q, typename... A>
+        requires(!std::is_void_v<Mapped>)
+    std::pair<iterator, bool> try_emplace(Q &&key, A &&...a) {
+        return emplace_key(std::forward<Q>(key), std::forward<A>(a)...);
+    }
+
+    template <typename Q>
+        requires(!std::is_void_v<Mapped>)
+    auto &operator[](Q &&key) {
+        return try_emplace(std::forward<Q>(key)).first->second;
+    }
+
+    template <typename Q = Key>
+        requires(!std::is_void_v<Mapped>)
+    const auto &at(const lookup_key<Q> &key) const {
+        auto it = find<Q>(key);
+        if (it == end()) {
+            throw std::out_of_range("flat_map::at: no such key");
+        }
+        return it->second;
+    }
+
+    template <typename Q = Key>
+        requires(!std::is_void_v<Mapped>)
+    auto &at(const lookup_key<Q> &key) {
+        auto it = find<Q>(key);
+        if (it == end()) {
+            throw std::out_of_range("flat_map::at: no such key");
+        }
+        return it->second;
+    }
+
+    template <typename Q = Key> size_t erase(const lookup_key<Q> &key) {
+        bool found;
+        size_t i = probe(key, found).first;
+        if (!found) {
+            return 0;
+        }
+        const uint32_t idx = _buckets[i].index;
+
+        // close the gap: shift the following displaced buckets back one
+        for (size_t next = (i + 1) & mask(); _buckets[next].dist_fp >= 2 * dist_one;
+             i = next, next = (next + 1) & mask()) {
+            _buckets[i] = {_buckets[next].dist_fp - dist_one, _buckets[next].index};
+        }
+        _buckets[i] = {};
+
+        // and move the last entry into the hole, repointing its bucket
+        const auto last = static_cast<uint32_t>(_values.size() - 1);
+        if (idx != last) {
+            bool moved;
+            const size_t j = probe(key_of(_values[last]), moved).first;
+            _buckets[j].index = idx;
+            _values[idx] = std::move(_values[last]);
+        }
+        _values.pop_back();
+        return 1;
+    }
+};
+} // namespace detail
+
+template <typename Key, typename Mapped, typename Hash = hash<Key>, typename Eq = std::equal_to<>>
+using flat_map = detail::flat_table<Key, Mapped, Hash, Eq>;
+
+template <typename Key, typename Hash = hash<Key>, typename Eq = std::equal_to<>>
+using flat_set = detail::flat_table<Key, void, Hash, Eq>;
+
+} // namespace prelude
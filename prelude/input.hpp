@@ -0,0 +1,465 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Input sources that hand out std::string_view lines instead of copying every
+// line into a std::string the way line_view does.
+
+namespace prelude {
+
+// The lines of a buffer as string_views pointing into it. Behaves like
+// std::getline: a trailing newline does not produce an empty last line.
+class lines_view : public std::ranges::view_interface<lines_view> {
+    std::string_view _text;
+
+  public:
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::string_view;
+
+        const char *cur = nullptr; // start of the current line, == end when done
+        const char *eol = nullptr; // the '\n' ending the current line, or end
+        const char *end = nullptr;
+
+        constexpr iterator() = default;
+        constexpr iterator(const char *b, const char *e) : cur(b), end(e) { find_eol(); }
+
+        constexpr reference operator*() const noexcept {
+            return std::string_view(cur, static_cast<size_t>(eol - cur));
+        }
+
+        constexpr iterator &operator++() {
+            cur = (eol == end) ? end : eol + 1;
+            find_eol();
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        friend constexpr bool operator==(const iterator &a, const iterator &b) noexcept {
+            return a.cur == b.cur;
+        }
+
+      private:
+        constexpr void find_eol() {
+            if (cur == end) {
+                eol = end;
+                return;
+            }
+            if (std::is_constant_evaluated()) {
+                for (eol = cur; eol != end && *eol != '\n'; ++eol) {
+                }
+                return;
+            }
+            auto nl = static_cast<const char *>(std::memchr(cur, '\n', end - cur));
+            eol = nl ? nl : end;
+        }
+    };
+
+    constexpr lines_view() = default;
+    constexpr explicit lines_view(std::string_view text) : _text(text) {}
+
+    constexpr iterator begin() const {
+        return iterator{_text.data(), _text.data() + _text.size()};
+    }
+    constexpr iterator end() const {
+        auto e = _text.data() + _text.size();
+        return iterator{e, e};
+    }
+};
+
+constexpr lines_view lines(std::string_view text) { return lines_view{text}; }
+
+constexpr size_t line_count(std::string_view text) {
+    return static_cast<size_t>(std::ranges::distance(lines(text)));
+}
+
+// f(line) for each of the first N lines of text, as a std::array. It's for
+// parsing at compile time, where nothing allocated can outlive the
+// evaluation, so there's no vector to collect into. N is usually
+// line_count(text).
+template <size_t N, typename F> constexpr auto map_lines(std::string_view text, F f) {
+    std::array<std::invoke_result_t<F &, std::string_view>, N> out{};
+    auto all = lines(text);
+    auto it = all.begin();
+    for (size_t i = 0; i < N; ++i, ++it) {
+        if (it == all.end()) {
+            throw std::invalid_argument("fewer lines than asked for");
+        }
+        out[i] = f(*it);
+    }
+    return out;
+}
+
+// The whole input in memory, from wherever the descriptor is up to (a
+// redirected stdin may have had a header read off it already) to the end.
+// Regular files (including a redirected stdin) are mmapped; anything else
+// (pipes, ttys) is read into a buffer we own. Either way text() and lines()
+// point into storage that lives as long as this does, so keep it around while
+// any of the views are in use.
+class mapped_input {
+    const char *_data = nullptr;
+    size_t _size = 0;
+    size_t _skip = 0; // mapped before _data, since mmap starts on a page
+    bool _mapped = false;
+    std::string _buffer;
+
+    void map_fd(int fd) {
+        struct stat st;
+        if (fstat(fd, &st) < 0) {
+            throw std::system_error(errno, std::generic_category(), "fstat");
+        }
+        if (!S_ISREG(st.st_mode)) {
+            slurp(fd);
+            return;
+        }
+        const off_t pos = ::lseek(fd, 0, SEEK_CUR);
+        if (pos < 0) {
+            throw std::system_error(errno, std::generic_category(), "lseek");
+        }
+        if (pos >= st.st_size) {
+            return;
+        }
+        const off_t start = pos - pos % static_cast<off_t>(sysconf(_SC_PAGESIZE));
+        _skip = static_cast<size_t>(pos - start);
+        _size = static_cast<size_t>(st.st_size - pos);
+        void *p = mmap(nullptr, _skip + _size, PROT_READ, MAP_PRIVATE, fd, start);
+        if (p == MAP_FAILED) {
+            _skip = _size = 0;
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+        madvise(p, _skip + _size, MADV_SEQUENTIAL);
+        _data = static_cast<const char *>(p) + _skip;
+        _mapped = true;
+    }
+
+    void slurp(int fd) {
+        char block[1 << 16];
+        while (true) {
+            ssize_t n = ::read(fd, block, sizeof(block));
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "read");
+            }
+            if (n == 0) {
+                break;
+            }
+            _buffer.append(block, static_cast<size_t>(n));
+        }
+        _data = _buffer.data();
+        _size = _buffer.size();
+    }
+
+    void release() {
+        if (_mapped) {
+            munmap(const_cast<char *>(_data - _skip), _skip + _size);
+        }
+        _data = nullptr;
+        _size = 0;
+        _skip = 0;
+        _mapped = false;
+    }
+
+  public:
+    // Defaults to stdin.
+    explicit mapped_input(int fd = STDIN_FILENO) { map_fd(fd); }
+
+    explicit mapped_input(const std::string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        try {
+            map_fd(fd);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd); // the mapping outlives the descriptor
+    }
+
+    mapped_input(const mapped_input &) = delete;
+    mapped_input &operator=(const mapped_input &) = delete;
+
+    mapped_input(mapped_input &&o) noexcept { *this = std::move(o); }
+    mapped_input &operator=(mapped_input &&o) noexcept {
+        if (this != &o) {
+            release();
+            _mapped = std::exchange(o._mapped, false);
+            _buffer = std::move(o._buffer);
+            _size = std::exchange(o._size, 0);
+            _skip = std::exchange(o._skip, 0);
+            _data = _mapped ? std::exchange(o._data, nullptr) : _buffer.data();
+            o._data = nullptr;
+        }
+        return *this;
+    }
+
+    ~mapped_input() { release(); }
+
+    bool mapped() const noexcept { return _mapped; }
+    std::string_view text() const noexcept { return std::string_view(_data, _size); }
+    lines_view lines() const noexcept { return lines_view{text()}; }
+};
+
+// The lines of a descriptor that can't be mapped (a pipe, a socket), read
+// ahead on a thread of its own into a ring of blocks, so the reading overlaps
+// with whatever is done with the lines instead of stopping it at every
+// getline the way line_view(std::cin) does:
+//
+//     prelude::readahead_lines in; // stdin
+//     for (std::string_view line : in) {
+//         ...
+//     }
+//
+// Single-pass, like line_view, but the lines are string_views: into the
+// block they're in, or for a line that straddles two, into a copy. Either way
+// a line only lasts until the iterator moves on. A trailing newline doesn't
+// make an empty last line. A failed read is rethrown by the increment that
+// needed it. With every block full and waiting, the reader waits too, so
+// memory stays at blocks * block_size however big the input is.
+class readahead_lines {
+    const int _fd;
+    const bool _owned;
+    const int _wake; // eventfd: tells a reader stuck in poll() to stop
+    const size_t _block_size;
+    std::vector<std::unique_ptr<char[]>> _blocks;
+
+    std::mutex _m;
+    std::condition_variable _cv;
+    std::deque<size_t> _free;
+    std::deque<std::pair<size_t, size_t>> _ready; // block, bytes read into it
+    bool _eof = false;
+    bool _stop = false;
+    std::exception_ptr _error;
+
+    // The consumer's side: the block it's in, how far it's got, and a line
+    // that started in an earlier block.
+    static constexpr size_t none = SIZE_MAX;
+    size_t _block = none;
+    std::string_view _rest;
+    std::string _carry;
+    std::string_view _line;
+
+    std::jthread _reader;
+
+    void read_ahead() {
+        while (true) {
+            size_t b;
+            {
+                std::unique_lock lk(_m);
+                _cv.wait(lk, [this] { return _stop || !_free.empty(); });
+                if (_stop) {
+                    return;
+                }
+                b = _free.front();
+                _free.pop_front();
+            }
+            pollfd fds[2] = {{_fd, POLLIN, 0}, {_wake, POLLIN, 0}};
+            ssize_t n;
+            do {
+                n = ::poll(fds, 2, -1);
+                if (n > 0 && fds[1].revents) {
+                    return;
+                }
+                if (n > 0) {
+                    n = ::read(_fd, _blocks[b].get(), _block_size);
+                }
+            } while (n < 0 && errno == EINTR);
+
+            std::lock_guard lk(_m);
+            if (n < 0) {
+                _error = std::make_exception_ptr(
+                    std::system_error(errno, std::generic_category(), "read"));
+            }
+            if (n <= 0) {
+                _eof = true;
+                _cv.notify_all();
+                return;
+            }
+            _ready.emplace_back(b, static_cast<size_t>(n));
+            _cv.notify_all();
+        }
+    }
+
+    // The next block into _rest, handing the last one back to the reader;
+    // false once there are no more.
+    bool next_block() {
+        std::unique_lock lk(_m);
+        if (_block != none) {
+            _free.push_back(std::exchange(_block, none));
+            _cv.notify_all();
+        }
+        _cv.wait(lk, [this] { return !_ready.empty() || _eof; });
+        if (_ready.empty()) {
+            if (_error) {
+                std::rethrow_exception(std::exchange(_error, nullptr));
+            }
+            return false;
+        }
+        auto [b, n] = _ready.front();
+        _ready.pop_front();
+        _block = b;
+        _rest = std::string_view(_blocks[b].get(), n);
+        return true;
+    }
+
+    // The next line into _line; false at the end.
+    bool next_line() {
+        _carry.clear();
+        bool partial = false;
+        while (true) {
+            if (auto nl = _rest.find('\n'); nl != std::string_view::npos) {
+                if (partial) {
+                    _carry.append(_rest.substr(0, nl));
+                    _line = _carry;
+                } else {
+                    _line = _rest.substr(0, nl);
+                }
+                _rest.remove_prefix(nl + 1);
+                return true;
+            }
+            if (!_rest.empty()) {
+                _carry.append(_rest);
+                _rest = {};
+                partial = true;
+            }
+            if (!next_block()) {
+                _line = _carry;
+                return partial;
+            }
+        }
+    }
+
+    void start(size_t blocks) {
+        if (_wake < 0) {
+            const int error = errno;
+            if (_owned) {
+                ::close(_fd);
+            }
+            throw std::system_error(error, std::generic_category(), "eventfd");
+        }
+        for (size_t i = 0; i < std::max<size_t>(2, blocks); ++i) {
+            _blocks.push_back(std::make_unique_for_overwrite<char[]>(_block_size));
+            _free.push_back(i);
+        }
+        _reader = std::jthread([this] { read_ahead(); });
+    }
+
+    static int open_path(const std::string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        return fd;
+    }
+
+  public:
+    static constexpr size_t default_block_size = size_t{1} << 18;
+    static constexpr size_t default_blocks = 8;
+
+    // Defaults to stdin. fd stays open; it's the caller's.
+    explicit readahead_lines(int fd = STDIN_FILENO, size_t block_size = default_block_size,
+                             size_t blocks = default_blocks)
+        : _fd(fd), _owned(false), _wake(::eventfd(0, EFD_CLOEXEC)),
+          _block_size(std::max<size_t>(1, block_size)) {
+        start(blocks);
+    }
+
+    explicit readahead_lines(const std::string &path, size_t block_size = default_block_size,
+                             size_t blocks = default_blocks)
+        : _fd(open_path(path)), _owned(true), _wake(::eventfd(0, EFD_CLOEXEC)),
+          _block_size(std::max<size_t>(1, block_size)) {
+        start(blocks);
+    }
+
+    readahead_lines(const readahead_lines &) = delete;
+    readahead_lines &operator=(const readahead_lines &) = delete;
+
+    ~readahead_lines() {
+        {
+            std::lock_guard lk(_m);
+            _stop = true;
+        }
+        _cv.notify_all();
+        if (_wake >= 0) {
+            const uint64_t one = 1;
+            [[maybe_unused]] auto n = ::write(_wake, &one, sizeof(one));
+        }
+        if (_reader.joinable()) {
+            _reader.join();
+        }
+        if (_wake >= 0) {
+            ::close(_wake);
+        }
+        if (_owned) {
+            ::close(_fd);
+        }
+    }
+
+    struct iterator {
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::string_view;
+
+        readahead_lines *src = nullptr; // null when done
+
+        reference operator*() const noexcept { return src->_line; }
+
+        iterator &operator++() {
+            if (!src->next_line()) {
+                src = nullptr;
+            }
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator &a, const iterator &b) noexcept {
+            return a.src == b.src;
+        }
+    };
+
+    // Once only: it's the lines that haven't been read yet.
+    iterator begin() { return ++iterator{this}; }
+    iterator end() { return iterator{}; }
+};
+
+} // namespace prelude
+
+template <> inline constexpr bool std::ranges::enable_borrowed_range<prelude::lines_view> = true;
@@ -0,0 +1,237 @@
+// main() for a single day's binary: solve the input named on the command
+// line, or stdin if there isn't one.
+//
+//     dayN [--timing=PATH] [--perf] [--trace=PATH] [--cache=DIR] [INPUT...]
+//     dayN --convert=PATH [INPUT]
+//
+// Given more than one input, or a directory (meaning every file in it), it
+// solves them all, side by side on the pool, and prints one line of JSON per
+// input, in the order given:
+//
+//     {"input": "a.txt", "part1": "42", "part2": "17"}
+//     {"input": "b.txt", "error": "malformed machine: ..."}
+//
+// The pool's threads live for the whole batch, so a day that keeps its setup
+// in a thread_local (2025 day10's z3 context) pays for it once a thread.
+//
+// --timing (or $AOC_TIMING) writes per-phase timings as JSON, and --perf (or
+// $AOC_PERF=1) adds hardware counters to them; see timing.hpp. In a batch
+// they're summed over the inputs, under "input".
+// --trace (or $AOC_TRACE_FILE) writes a Chrome trace, in builds with tracing
+// compiled in; see trace.hpp.
+// --cache (or $AOC_CACHE) keeps answers in DIR and reuses them for inputs it
+// has seen before; see cache.hpp.
+//
+// --convert parses the input and saves it to PATH as columns, for days that
+// have a columnar format (columnar.hpp). Any INPUT can be such a file, which
+// is loaded instead of parsed.
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#include "prelude/aoc.hpp"
+#include "prelude/cache.hpp"
+#include "prelude/input.hpp"
+#include "prelude/parallel.hpp"
+#include "prelude/simd.hpp"
+#include "prelude/timing.hpp"
+#include "prelude/trace.hpp"
+
+namespace {
+
+// The files named, with each directory replaced by the files in it, sorted.
+std::vector<std::string> expand(const std::vector<std::string> &args) {
+    std::vector<std::string> paths;
+    for (const auto &arg : args) {
+        if (!std::filesystem::is_directory(arg)) {
+            paths.push_back(arg);
+            continue;
+        }
+        std::vector<std::string> files;
+        for (const auto &entry : std::filesystem::directory_iterator(arg)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::ranges::sort(files);
+        paths.insert(paths.end(), files.begin(), files.end());
+    }
+    return paths;
+}
+
+struct batch_line {
+    std::string json;
+    bool ok;
+};
+
+// One input of a batch, as a line of JSON.
+batch_line solve_one(const prelude::solution &s, const std::string &path,
+                     const prelude::answer_cache *cache) {
+    using prelude::detail::json_string;
+    prelude::scoped_timer t(prelude::scoped_timer::top_level, "input");
+    AOC_TRACE_SPAN("input");
+    try {
+        std::optional<prelude::mapped_input> input;
+        {
+            prelude::scoped_timer t("read");
+            AOC_TRACE_SPAN("read");
+            input.emplace(path);
+        }
+        auto answers = prelude::solve(s, input->text(), cache);
+        std::string line = fmt::format("{{\"input\": {}, \"part1\": {}", json_string(path),
+                                       json_string(answers.part1));
+        if (s.part2) {
+            line += fmt::format(", \"part2\": {}", json_string(answers.part2));
+        }
+        return {line + "}\n", true};
+    } catch (const std::exception &e) {
+        return {fmt::format("{{\"input\": {}, \"error\": {}}}\n", json_string(path),
+                            json_string(e.what())),
+                false};
+    }
+}
+
+// Every input at once, each line printed as soon as it and all the ones
+// before it are done. Fails if any input did.
+int solve_batch(const prelude::solution &s, const std::vector<std::string> &paths,
+                const prelude::answer_cache *cache) {
+    std::vector<std::optional<std::string>> lines(paths.size());
+    std::mutex m;
+    size_t printed = 0;
+    bool failed = false;
+    prelude::default_pool().parallel_for(paths.size(), [&](size_t i) {
+        auto line = solve_one(s, paths[i], cache);
+        std::lock_guard lk(m);
+        failed |= !line.ok;
+        lines[i] = std::move(line.json);
+        for (; printed < lines.size() && lines[printed]; ++printed) {
+            std::fputs(lines[printed]->c_str(), stdout);
+            lines[printed].reset();
+        }
+        std::fflush(stdout);
+    });
+    return failed ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    auto &solutions = prelude::registry();
+    if (solutions.size() != 1) {
+        spdlog::error("expected exactly one registered solution, found {}", solutions.size());
+        return 1;
+    }
+    const auto &solution = solutions.front();
+
+    std::vector<std::string> args;
+    bool perf = false;
+    std::optional<std::string> cache_dir;
+    std::optional<std::string> convert;
+    if (const char *env = std::getenv("AOC_CACHE"); env && *env) {
+        cache_dir = env;
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--timing=")) {
+            prelude::timing().enable(std::string(arg.substr(9)));
+        } else if (arg == "--perf") {
+            perf = true;
+        } else if (arg.starts_with("--trace=")) {
+#ifdef AOC_TRACE
+            prelude::trace().enable(std::string(arg.substr(8)));
+#else
+            spdlog::warn("built without tracing, ignoring --trace (build with --define trace=1)");
+#endif
+        } else if (arg.starts_with("--cache=")) {
+            cache_dir = arg.substr(8);
+        } else if (arg.starts_with("--convert=")) {
+            convert = arg.substr(10);
+        } else if (!arg.starts_with("--")) {
+            args.emplace_back(arg);
+        } else {
+            spdlog::error("usage: {} [--timing=PATH] [--perf] [--trace=PATH] [--cache=DIR] "
+                          "[--convert=PATH] [INPUT...]",
+                          argv[0]);
+            return 1;
+        }
+    }
+
+    auto &timing = prelude::timing();
+    if (perf) {
+        timing.enable_perf();
+        if (!timing.enabled()) {
+            timing.enable("-");
+        }
+    }
+    timing.annotate("solution", solution.name());
+    timing.annotate("simd", prelude::simd::name(prelude::simd::current()));
+
+    std::optional<prelude::answer_cache> cache;
+    if (cache_dir) {
+        try {
+            cache.emplace(*cache_dir);
+            timing.annotate("cache", *cache_dir);
+        } catch (const std::exception &e) {
+            spdlog::warn("not caching answers: {}", e.what());
+        }
+    }
+    const prelude::answer_cache *cache_ptr = cache ? &*cache : nullptr;
+
+    if (args.size() > 1 || (args.size() == 1 && std::filesystem::is_directory(args[0]))) {
+        if (convert) {
+            spdlog::error("--convert takes a single input");
+            return 1;
+        }
+        auto paths = expand(args);
+        timing.annotate("inputs", static_cast<long>(paths.size()));
+        return solve_batch(solution, paths, cache_ptr);
+    }
+    std::optional<std::string> path;
+    if (!args.empty()) {
+        path = args.front();
+    }
+    timing.annotate("input", path.value_or("-"));
+
+    try {
+        std::optional<prelude::mapped_input> input;
+        {
+            prelude::scoped_timer t("read");
+            AOC_TRACE_SPAN("read");
+            input.emplace(path ? prelude::mapped_input(*path) : prelude::mapped_input());
+        }
+        timing.annotate("input_bytes", static_cast<long>(input->text().size()));
+        if (convert) {
+            const auto bytes = prelude::to_columnar(solution, input->text());
+            std::ofstream out(*convert, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            out.close();
+            if (!out) {
+                throw std::runtime_error(fmt::format("can't write {}", *convert));
+            }
+            spdlog::info("saved {} as {} ({} bytes)", path.value_or("stdin"), *convert,
+                         bytes.size());
+            return 0;
+        }
+        auto answers = prelude::solve(solution, input->text(), cache_ptr);
+        fmt::print("part 1: {}\n", answers.part1);
+        if (solution.part2) {
+            fmt::print("part 2: {}\n", answers.part2);
+        }
+    } catch (const std::exception &e) {
+        spdlog::error("{}: {}", solution.name(), e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "prelude/input.hpp"
+#include "prelude/trace.hpp"
+
+// Multi-threaded helpers. Nothing fancy: split the work into pieces, do them
+// on a shared pool, stitch the results back together in order.
+
+namespace prelude {
+
+// How many threads to use: $AOC_THREADS if it's set to something positive,
+// otherwise one per core.
+inline size_t thread_count() {
+    if (const char *env = std::getenv("AOC_THREADS")) {
+        if (long n = std::strtol(env, nullptr, 10); n > 0) {
+            return static_cast<size_t>(n);
+        }
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+// A small work-stealing pool. Every worker owns a deque: it pushes and pops
+// its own work at the back and, when that runs dry, steals from the front of
+// everyone else's. Whoever waits on a batch of work (including a worker, for
+// nested parallelism) runs queued tasks while there are any, so a pool of n
+// threads has n - 1 workers plus the caller, and a pool of 1 is just serial.
+// With nothing left to run it sleeps until there is, or its batch is done.
+class thread_pool {
+    struct queue {
+        std::mutex m;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<queue>> _queues;
+    std::vector<std::jthread> _workers;
+    std::mutex _sleep_m;
+    std::condition_variable _sleep_cv;
+    std::atomic<size_t> _pending{0};
+    std::atomic<size_t> _next{0};
+    size_t _asleep = 0; // under _sleep_m
+    bool _stop = false;
+
+    static inline thread_local const thread_pool *tl_pool = nullptr;
+    static inline thread_local size_t tl_index = 0;
+
+    size_t home() {
+        return tl_pool == this ? tl_index : _next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::optional<std::function<void()>> take(size_t start) {
+        const size_t n = _queues.size();
+        for (size_t k = 0; k < n; ++k) {
+            auto &q = *_queues[(start + k) % n];
+            std::lock_guard lk(q.m);
+            if (!q.tasks.empty()) {
+                std::function<void()> task;
+                if (k == 0) {
+                    task = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                } else {
+                    task = std::move(q.tasks.front());
+                    q.tasks.pop_front();
+                }
+                _pending.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Sleep until ready(), counted in _asleep meanwhile.
+    template <typename Ready> void sleep_until(Ready ready) {
+        std::unique_lock lk(_sleep_m);
+        ++_asleep;
+        _sleep_cv.wait(lk, ready);
+        --_asleep;
+    }
+
+    void work(size_t index) {
+        tl_pool = this;
+        tl_index = index;
+        while (true) {
+            if (run_one()) {
+                continue;
+            }
+            sleep_until([this] { return _stop || _pending.load() > 0; });
+            if (_stop) {
+                return;
+            }
+        }
+    }
+
+  public:
+    explicit thread_pool(size_t threads = thread_count()) {
+        const size_t workers = std::max<size_t>(1, threads) - 1;
+        for (size_t i = 0; i < std::max<size_t>(1, workers); ++i) {
+            _queues.push_back(std::make_unique<queue>());
+        }
+        for (size_t i = 0; i < workers; ++i) {
+            _workers.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard lk(_sleep_m);
+            _stop = true;
+        }
+        _sleep_cv.notify_all();
+        for (auto &w : _workers) {
+            w.join();
+        }
+    }
+
+    // Threads that run work, counting the caller.
+    size_t size() const { return _workers.size() + 1; }
+
+    // Threads asleep for want of work, workers and waiting callers both.
+    size_t asleep() {
+        std::lock_guard lk(_sleep_m);
+        return _asleep;
+    }
+
+    void submit(std::function<void()> task) {
+        auto &q = *_queues[home() % _queues.size()];
+        // Counted before anyone can take it, so the count never goes below
+        // what's really queued.
+        _pending.fetch_add(1);
+        {
+            std::lock_guard lk(q.m);
+            q.tasks.push_back(std::move(task));
+        }
+        { std::lock_guard lk(_sleep_m); }
+        _sleep_cv.notify_one();
+    }
+
+    // Run one queued task on this thread, if there is one.
+    bool run_one() {
+        auto task = take(tl_pool == this ? tl_index : 0);
+        if (!task) {
+            return false;
+        }
+        (*task)();
+        return true;
+    }
+
+    // f(i) for every i in [0, n), spread across the pool. Returns once they've
+    // all run; the first exception thrown by any of them is rethrown here.
+    template <typename F> void parallel_for(size_t n, F &&f) {
+        if (n == 0) {
+            return;
+        }
+        if (n == 1 || _workers.empty()) {
+            for (size_t i = 0; i < n; ++i) {
+                f(i);
+            }
+            return;
+        }
+
+        std::atomic<size_t> remaining{n};
+        std::exception_ptr error;
+        std::mutex error_m;
+        for (size_t i = 0; i < n; ++i) {
+            submit([&, i] {
+                try {
+                    f(i);
+                } catch (...) {
+                    std::lock_guard lk(error_m);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    { std::lock_guard lk(_sleep_m); }
+                    _sleep_cv.notify_all();
+                }
+            });
+        }
+        auto done = [&] { return remaining.load(std::memory_order_acquire) == 0; };
+        while (!done()) {
+            if (run_one()) {
+                continue;
+            }
+            // The rest are running elsewhere: wait for them, or for something
+            // new to help with (tasks they submit in turn, say).
+            sleep_until([&] { return done() || _pending.load() > 0; });
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+// The pool everything uses unless told otherwise, sized by thread_count().
+inline thread_pool &default_pool() {
+    // Made first so it's destroyed last, after the workers that record into
+    // it have joined (see ~tracer).
+    trace();
+    static thread_pool pool;
+    return pool;
+}
+
+// Split text into at most n pieces, each ending just after a '\n' (except the
+// last, which ends wherever text does), so every line lands whole in exactly
+// one chunk. The boundary search is memchr, which libc already vectorizes.
+inline std::vector<std::string_view> chunk_lines(std::string_view text, size_t n) {
+    std::vector<std::string_view> chunks;
+    const size_t size = text.size();
+    size_t begin = 0;
+    for (size_t i = 1; i <= n && begin < size; ++i) {
+        size_t end = (i == n) ? size : std::max(begin, size / n * i);
+        if (end < size) {
+            auto nl = static_cast<const char *>(std::memchr(text.data() + end, '\n', size - end));
+            end = nl ? static_cast<size_t>(nl - text.data()) + 1 : size;
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+// par_lines(text, f): f applied to every line of text, in order, with the
+// lines parsed in newline-aligned chunks across the pool. Chunks smaller
+// than min_chunk bytes aren't worth a thread, so small inputs stay serial.
+template <typename F>
+auto par_lines(std::string_view text, F f, size_t min_chunk = size_t{1} << 16,
+               thread_pool &pool = default_pool()) {
+    using T = std::decay_t<std::invoke_result_t<const F &, std::string_view>>;
+
+    const size_t n
+        = std::clamp<size_t>(text.size() / std::max<size_t>(1, min_chunk), 1, pool.size());
+    auto chunks = chunk_lines(text, n);
+
+    std::vector<std::vector<T>> parts(chunks.size());
+    pool.parallel_for(chunks.size(), [&](size_t i) {
+        AOC_TRACE_SPAN("par_lines chunk", "chunk", static_cast<long>(i));
+        for (auto line : lines(chunks[i])) {
+            parts[i].push_back(std::invoke(f, line));
+        }
+    });
+
+    if (parts.size() == 1) {
+        return std::move(parts.front());
+    }
+    std::vector<T> out;
+    size_t total = 0;
+    for (auto &p : parts) {
+        total += p.size();
+    }
+    out.reserve(total);
+    for (auto &p : parts) {
+        out.insert(out.end(), std::make_move_iterator(p.begin()), std::make_move_iterator(p.end()));
+    }
+    return out;
+}
+
+//
+// range | par_reduce(init, op), range | par_sum, range | par_product
+//
+// Parallel counterparts of reduce/sum/product for sized random-access ranges
+// (vectors, and transform views over them, which is where the per-item work
+// gets done). op has to be associative and take (T, T) -> T. The range is cut
+// into blocks that depend only on its size, each block is folded left to
+// right, and the block results are folded in order, so the answer doesn't
+// depend on the thread count or on which thread finished first.
+//
+namespace detail {
+inline constexpr size_t par_blocks = 256;
+
+template <typename T, std::ranges::random_access_range R, typename BinaryOp>
+    requires std::ranges::sized_range<R>
+T par_fold(R &&r, T init, const BinaryOp &op, thread_pool &pool) {
+    const size_t n = std::ranges::size(r);
+    if (n == 0) {
+        return init;
+    }
+    const size_t block = (n + par_blocks - 1) / par_blocks;
+    const size_t blocks = (n + block - 1) / block;
+    auto first = std::ranges::begin(r);
+
+    std::vector<std::optional<T>> partials(blocks);
+    pool.parallel_for(blocks, [&](size_t b) {
+        AOC_TRACE_SPAN("par_reduce block", "block", static_cast<long>(b));
+        auto it = first + static_cast<std::ranges::range_difference_t<R>>(b * block);
+        const size_t len = std::min(block, n - b * block);
+        T acc = static_cast<T>(*it);
+        for (size_t i = 1; i < len; ++i) {
+            ++it;
+            acc = op(std::move(acc), static_cast<T>(*it));
+        }
+        partials[b] = std::move(acc);
+    });
+
+    for (auto &p : partials) {
+        init = op(std::move(init), std::move(*p));
+    }
+    return init;
+}
+
+struct par_reduce_fn {
+    template <typename T, typename BinaryOp> struct pipeable {
+        T init;
+        BinaryOp op;
+        thread_pool *pool;
+
+        template <std::ranges::random_access_range R>
+            requires std::ranges::sized_range<R>
+        friend T operator|(R &&r, const pipeable &self) {
+            return par_fold(std::forward<R>(r), self.init, self.op, *self.pool);
+        }
+    };
+
+    template <typename T, typename BinaryOp>
+    auto operator()(T init, BinaryOp op, thread_pool &pool = default_pool()) const {
+        return pipeable<T, BinaryOp>{init, op, &pool};
+    }
+};
+
+struct par_sum_fn {
+    template <std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R>
+    friend auto operator|(R &&r, par_sum_fn) {
+        using T = std::ranges::range_value_t<std::decay_t<R>>;
+        return par_fold(std::forward<R>(r), T{0}, std::plus<>{}, default_pool());
+    }
+};
+
+struct par_product_fn {
+    template <std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R>
+    friend auto operator|(R &&r, par_product_fn) {
+        using T = std::ranges::range_value_t<std::decay_t<R>>;
+        return par_fold(std::forward<R>(r), T{1}, std::multiplies<>{}, default_pool());
+    }
+};
+} // namespace detail
+
+inline constexpr detail::par_reduce_fn par_reduce;
+inline constexpr detail::par_sum_fn par_sum;
+inline constexpr detail::par_product_fn par_product;
+
+} // namespace prelude
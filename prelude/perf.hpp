@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <fmt/core.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Hardware performance counters from perf_event_open(2), for telling
+// memory-bound phases (cache and LLC numbers) from branch-bound ones. Only
+// the stock counters every Linux PMU driver offers are used, counting user
+// space only so the default perf_event_paranoid of 2 allows them.
+//
+// Counters that can't be opened (no PMU in a VM or container, a stricter
+// perf_event_paranoid, seccomp) are just left out, and error() says why.
+// The counters follow threads created after they're opened, so open them
+// before the pool starts.
+
+namespace prelude {
+
+struct perf_event_spec {
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+};
+
+inline constexpr std::array<perf_event_spec, 5> perf_events = {{
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"llc_loads", PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+         | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16)},
+}};
+
+// One reading of every counter, indexed like perf_events.
+using perf_sample = std::array<long, perf_events.size()>;
+
+class perf_counters {
+    std::array<int, perf_events.size()> _fds;
+    std::string _error;
+
+  public:
+    perf_counters() {
+        _fds.fill(-1);
+        for (size_t i = 0; i < perf_events.size(); ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = perf_events[i].type;
+            attr.config = perf_events[i].config;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.inherit = 1;
+            const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+            if (fd < 0) {
+                if (_error.empty()) {
+                    _error = fmt::format("{}: {}", perf_events[i].name, std::strerror(errno));
+                }
+                continue;
+            }
+            _fds[i] = static_cast<int>(fd);
+        }
+    }
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    ~perf_counters() {
+        for (int fd : _fds) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool available(size_t i) const { return _fds[i] >= 0; }
+
+    bool any() const {
+        for (size_t i = 0; i < _fds.size(); ++i) {
+            if (available(i)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Why the first counter that failed to open did; empty if none did.
+    const std::string &error() const { return _error; }
+
+    // Counts so far, scaled up for the time a counter was multiplexed out.
+    // Unavailable counters read 0.
+    perf_sample read() const {
+        perf_sample s{};
+        for (size_t i = 0; i < _fds.size(); ++i) {
+            uint64_t v[3]; // value, time enabled, time running
+            if (_fds[i] < 0 || ::read(_fds[i], v, sizeof(v)) != sizeof(v) || v[2] == 0) {
+                continue;
+            }
+            s[i] = static_cast<long>(v[2] == v[1] ? v[0] : double(v[0]) * v[1] / v[2]);
+        }
+        return s;
+    }
+};
+
+} // namespace prelude
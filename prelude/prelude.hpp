@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <format>
@@ -7,15 +10,22 @@
 #include <functional>
 #include <iostream>
 #include <iterator>
+#include <memory_resource>
 #include <numeric>
+#include <optional>
 #include <ranges>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include <fmt/core.h>
 #include <spdlog/spdlog.h>
 
@@ -29,7 +39,7 @@ namespace rv = std::ranges::views;
 namespace prelude {
 
 template <typename R> auto front(R &&r) {
-    for (auto &x : r) {
+    for (auto &&x : r) {
         return x;
     }
     throw std::logic_error("this does not work with empty ranges");
@@ -127,6 +137,39 @@ template <template <class...> class C> struct collect_fn {
     template <std::ranges::input_range R> friend auto operator|(R &&r, collect_fn self) {
         return self(std::forward<R>(r));
     }
+
+    // collect<C>(mr)(range) or range | collect<C>(mr), for allocator-aware
+    // containers (prelude::pmr::vector and friends) that should allocate
+    // from mr, usually an arena.
+    struct with_resource {
+        std::pmr::memory_resource *mr;
+
+        template <std::ranges::input_range R> auto operator()(R &&r) const {
+            using T = std::ranges::range_value_t<R>;
+
+            if constexpr (requires { C<T>(std::ranges::begin(r), std::ranges::end(r), mr); }) {
+                return C<T>(std::ranges::begin(r), std::ranges::end(r), mr);
+            } else {
+                C<T> out(mr);
+
+                if constexpr (std::ranges::sized_range<R>
+                              && requires { out.reserve(std::ranges::size(r)); }) {
+                    out.reserve(std::ranges::size(r));
+                }
+
+                for (auto &&v : r)
+                    out.emplace_back(v);
+
+                return out;
+            }
+        }
+
+        template <std::ranges::input_range R> friend auto operator|(R &&r, with_resource self) {
+            return self(std::forward<R>(r));
+        }
+    };
+
+    with_resource operator()(std::pmr::memory_resource *mr) const { return {mr}; }
 };
 } // namespace detail
 template <template <class...> class C> inline constexpr detail::collect_fn<C> collect{};
@@ -233,37 +276,396 @@ inline constexpr detail::run_length_fn run_length;
 
 // string stuff
 
-std::string chomp(std::string s) {
-    auto is_space = [](char c) { return std::isspace((unsigned char)c); };
+//
+// ints(sv): every integer in sv, as a lazy range of T (long by default).
+// ints<N>(sv): the first N of them as a std::array, throwing if there aren't
+// that many.
+//
+// No allocation and no std::string temporaries. For signed T a '-' directly
+// before the digits is a sign, unless it's itself preceded by a digit, so
+// "3-5" is {3, 5} but "3,-5" is {3, -5}. Unsigned T ignores signs entirely.
+//
+namespace detail {
+constexpr bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+// The run of digits at p as a T (negated if asked), leaving p just past them.
+template <std::integral T>
+constexpr T read_digits(const char *&p, const char *last, bool negative) {
+    T v = 0;
+    for (; p != last && is_digit(*p); ++p) {
+        const T d = static_cast<T>(*p - '0');
+        if (__builtin_mul_overflow(v, T{10}, &v)
+            || (negative ? __builtin_sub_overflow(v, d, &v) : __builtin_add_overflow(v, d, &v))) {
+            throw std::out_of_range("integer doesn't fit");
+        }
+    }
+    return v;
+}
+} // namespace detail
+
+template <std::integral T> class ints_view : public std::ranges::view_interface<ints_view<T>> {
+    std::string_view _text;
+
+  public:
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = T;
+
+        const char *first = nullptr; // start of the text, for looking behind a '-'
+        const char *cur = nullptr;   // start of the current number, == last when done
+        const char *next = nullptr;  // just past the current number
+        const char *last = nullptr;
+        T value{};
+
+        constexpr iterator() = default;
+        constexpr iterator(const char *f, const char *from, const char *l)
+            : first(f), next(from), last(l) {
+            advance();
+        }
+
+        constexpr T operator*() const noexcept { return value; }
+
+        constexpr iterator &operator++() {
+            advance();
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        friend constexpr bool operator==(const iterator &a, const iterator &b) noexcept {
+            return a.cur == b.cur;
+        }
+
+      private:
+        constexpr void advance() {
+            using detail::is_digit;
+            const char *p = next;
+            while (p != last && !is_digit(*p)) {
+                ++p;
+            }
+            if (p == last) {
+                cur = next = last;
+                return;
+            }
+
+            bool negative = false;
+            cur = p;
+            if constexpr (std::is_signed_v<T>) {
+                if (p != first && p[-1] == '-' && (p - 1 == first || !is_digit(p[-2]))) {
+                    negative = true;
+                    --cur;
+                }
+            }
+
+            value = detail::read_digits<T>(p, last, negative);
+            next = p;
+        }
+    };
 
-    auto first = std::ranges::find_if_not(s, is_space);
-    auto last = std::ranges::find_if_not(s | std::views::reverse, is_space).base();
+    constexpr ints_view() = default;
+    constexpr explicit ints_view(std::string_view text) : _text(text) {}
+
+    constexpr iterator begin() const {
+        return iterator{_text.data(), _text.data(), _text.data() + _text.size()};
+    }
+    constexpr iterator end() const {
+        auto e = _text.data() + _text.size();
+        return iterator{_text.data(), e, e};
+    }
+};
 
-    return (first < last) ? std::string(first, last) : std::string{};
+template <std::integral T = long> constexpr ints_view<T> ints(std::string_view s) {
+    return ints_view<T>{s};
 }
 
-std::vector<std::string> split_ws(std::string_view sv) {
-    std::vector<std::string> out;
-    size_t i = 0, n = sv.size();
+template <size_t N, std::integral T = long> constexpr std::array<T, N> ints(std::string_view s) {
+    std::array<T, N> out{};
+    auto found = ints_view<T>{s};
+    auto it = found.begin();
+    for (size_t i = 0; i < N; ++i, ++it) {
+        if (it == found.end()) {
+            throw std::invalid_argument("not enough integers");
+        }
+        out[i] = *it;
+    }
+    return out;
+}
 
-    while (i < n) {
-        // skip whitespace
-        while (i < n && std::isspace((unsigned char)sv[i]))
-            ++i;
+//
+// scan<"pattern", Ts...>(sv): match sv against a pattern where each {} is a
+// field, and hand back the fields as std::optional<std::tuple<Ts...>>, or
+// nullopt if sv doesn't fit. With no Ts every field is a std::string_view.
+//
+//   scan<"turn {} {},{} through {},{}", std::string_view, int, int, int, int>(line)
+//
+// Integer fields take an optional '-' and a run of digits, char fields take
+// one char, and string_view fields take everything up to the literal text
+// that follows them (or the rest of the line). {{ and }} are literal braces.
+// The pattern is checked at compile time and nothing allocates.
+//
+namespace detail {
+template <size_t N> struct pattern_string {
+    char chars[N]{};
 
-        size_t start = i;
+    constexpr pattern_string(const char (&s)[N]) { std::copy_n(s, N, chars); }
+    constexpr std::string_view view() const { return std::string_view(chars, N - 1); }
+};
 
-        // consume non-whitespace
-        while (i < n && !std::isspace((unsigned char)sv[i]))
-            ++i;
+// A pattern cut into the literal text around its fields, with {{ and }}
+// already unescaped: literal(0) {} literal(1) {} ... literal(fields).
+template <pattern_string P> struct scan_pattern {
+    // Walks the pattern, calling on_literal(char) and on_field(), and says
+    // whether it was well formed.
+    static constexpr bool walk(auto on_literal, auto on_field) {
+        auto p = P.view();
+        for (size_t i = 0; i < p.size(); ++i) {
+            if (p[i] == '{' && i + 1 < p.size() && p[i + 1] == '}') {
+                on_field();
+                ++i;
+            } else if ((p[i] == '{' || p[i] == '}') && i + 1 < p.size() && p[i + 1] == p[i]) {
+                on_literal(p[i]);
+                ++i;
+            } else if (p[i] == '{' || p[i] == '}') {
+                return false;
+            } else {
+                on_literal(p[i]);
+            }
+        }
+        return true;
+    }
 
-        if (start < i)
-            out.emplace_back(sv.substr(start, i - start));
+    static constexpr bool valid = walk([](char) {}, [] {});
+    static_assert(valid, "scan patterns take {} fields and {{ or }} for literal braces");
+
+    static constexpr size_t fields = [] {
+        size_t n = 0;
+        walk([](char) {}, [&n] { ++n; });
+        return n;
+    }();
+
+    // all literal text back to back, plus where each piece starts
+    static constexpr auto layout = [] {
+        std::pair<std::array<char, sizeof(P.chars)>, std::array<size_t, fields + 2>> out{};
+        size_t len = 0, field = 0;
+        walk([&](char c) { out.first[len++] = c; }, [&] { out.second[++field] = len; });
+        out.second[fields + 1] = len;
+        return out;
+    }();
+
+    static constexpr std::string_view literal(size_t i) {
+        return std::string_view(layout.first.data() + layout.second[i],
+                                layout.second[i + 1] - layout.second[i]);
     }
+};
+
+template <typename T>
+constexpr bool scan_field(std::string_view &s, std::string_view next, T &out) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+        const size_t end = next.empty() ? s.size() : s.find(next);
+        if (end == std::string_view::npos) {
+            return false;
+        }
+        out = s.substr(0, end);
+        s.remove_prefix(end);
+        return true;
+    } else if constexpr (std::is_same_v<T, char>) {
+        if (s.empty()) {
+            return false;
+        }
+        out = s.front();
+        s.remove_prefix(1);
+        return true;
+    } else {
+        static_assert(std::is_integral_v<T>, "scan fields are integers, chars or string_views");
+        const char *p = s.data();
+        const char *last = s.data() + s.size();
+        bool negative = false;
+        if constexpr (std::is_signed_v<T>) {
+            if (p != last && *p == '-') {
+                negative = true;
+                ++p;
+            }
+        }
+        if (p == last || !is_digit(*p)) {
+            return false;
+        }
+        out = read_digits<T>(p, last, negative);
+        s.remove_prefix(static_cast<size_t>(p - s.data()));
+        return true;
+    }
+}
 
+template <size_t, typename T> using repeat_type = T;
+
+template <pattern_string P, typename... Ts>
+constexpr std::optional<std::tuple<Ts...>> scan_as(std::string_view s) {
+    using pat = scan_pattern<P>;
+    static_assert(pat::fields == sizeof...(Ts), "scan needs one type per {} in the pattern");
+
+    static_assert(
+        []<size_t... I>(std::index_sequence<I...>) {
+            return ((!std::is_same_v<Ts, std::string_view> || I + 1 == sizeof...(Ts)
+                     || !pat::literal(I + 1).empty())
+                    && ...);
+        }(std::index_sequence_for<Ts...>{}),
+        "a string_view field needs literal text after it");
+
+    std::tuple<Ts...> out{};
+    auto literal = [&s](std::string_view lit) {
+        if (!s.starts_with(lit)) {
+            return false;
+        }
+        s.remove_prefix(lit.size());
+        return true;
+    };
+    bool ok = [&]<size_t... I>(std::index_sequence<I...>) {
+        return literal(pat::literal(0))
+               && ((scan_field(s, pat::literal(I + 1), std::get<I>(out))
+                    && literal(pat::literal(I + 1)))
+                   && ...);
+    }(std::index_sequence_for<Ts...>{});
+
+    if (!ok || !s.empty()) {
+        return std::nullopt;
+    }
     return out;
 }
 
+template <pattern_string P, size_t... I>
+constexpr auto scan_views(std::string_view s, std::index_sequence<I...>) {
+    return scan_as<P, repeat_type<I, std::string_view>...>(s);
+}
+} // namespace detail
+
+template <detail::pattern_string P, typename... Ts> constexpr auto scan(std::string_view s) {
+    if constexpr (sizeof...(Ts) == 0) {
+        return detail::scan_views<P>(s,
+                                     std::make_index_sequence<detail::scan_pattern<P>::fields>{});
+    } else {
+        return detail::scan_as<P, Ts...>(s);
+    }
+}
+
+//
+// Whitespace handling that hands back string_views into the caller's buffer,
+// so nothing is copied or allocated per token. The flip side: the buffer has
+// to outlive the views.
+//
+// Whitespace is what std::isspace means in the C locale. On x86 the scans
+// classify 16 bytes at a time with SSE2.
+//
+namespace detail {
+constexpr bool is_ws(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+// The first char in [p, end) that is whitespace (space == true) or isn't.
+constexpr const char *find_ws(const char *p, const char *end, bool space) {
+#if defined(__SSE2__)
+    if !consteval {
+        const __m128i blank = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i four = _mm_set1_epi8(4);
+        for (; end - p >= 16; p += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            // '\t'..'\r' are the five chars with (c - '\t') <= 4, unsigned
+            const __m128i ctl = _mm_sub_epi8(v, tab);
+            const __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, blank),
+                                            _mm_cmpeq_epi8(_mm_min_epu8(ctl, four), ctl));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(ws));
+            if (!space) {
+                mask = ~mask & 0xffff;
+            }
+            if (mask) {
+                return p + __builtin_ctz(mask);
+            }
+        }
+    }
+#endif
+    while (p != end && is_ws(*p) != space) {
+        ++p;
+    }
+    return p;
+}
+} // namespace detail
+
+// s without leading or trailing whitespace.
+constexpr std::string_view chomp(std::string_view s) {
+    const char *last = s.data() + s.size();
+    const char *first = detail::find_ws(s.data(), last, false);
+    while (last != first && detail::is_ws(last[-1])) {
+        --last;
+    }
+    return std::string_view(first, static_cast<size_t>(last - first));
+}
+
+// The whitespace-separated tokens of a string_view, found lazily.
+class tokens_view : public std::ranges::view_interface<tokens_view> {
+    std::string_view _text;
+
+  public:
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::string_view;
+
+        const char *cur = nullptr; // start of the current token, == last when done
+        const char *next = nullptr; // just past the current token
+        const char *last = nullptr;
+
+        constexpr iterator() = default;
+        constexpr iterator(const char *from, const char *l) : next(from), last(l) { advance(); }
+
+        constexpr reference operator*() const noexcept {
+            return std::string_view(cur, static_cast<size_t>(next - cur));
+        }
+
+        constexpr iterator &operator++() {
+            advance();
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        friend constexpr bool operator==(const iterator &a, const iterator &b) noexcept {
+            return a.cur == b.cur;
+        }
+
+      private:
+        constexpr void advance() {
+            cur = detail::find_ws(next, last, false);
+            next = detail::find_ws(cur, last, true);
+        }
+    };
+
+    constexpr tokens_view() = default;
+    constexpr explicit tokens_view(std::string_view text) : _text(text) {}
+
+    constexpr iterator begin() const {
+        return iterator{_text.data(), _text.data() + _text.size()};
+    }
+    constexpr iterator end() const {
+        auto e = _text.data() + _text.size();
+        return iterator{e, e};
+    }
+};
+
+constexpr tokens_view tokens(std::string_view s) { return tokens_view{s}; }
+
+// tokens(), collected.
+inline std::vector<std::string_view> split_ws(std::string_view sv) {
+    return tokens(sv) | collect<std::vector>;
+}
+
 template <typename Collection> Collection transpose(Collection &orig) {
     Collection reformed;
     const size_t R = orig.size();
@@ -274,7 +676,7 @@ template <typename Collection> Collection transpose(Collection &orig) {
         for (size_t j = 0; j < R; ++j) {
             r.push_back(orig[j][i]);
         }
-        reformed.push_back(prelude::chomp(r));
+        reformed.emplace_back(prelude::chomp(r));
     }
     return reformed;
 }
@@ -282,3 +684,7 @@ template <typename Collection> Collection transpose(Collection &orig) {
 template <typename R> auto pairwise(R &&r) { return rv::zip(r, std::ranges::drop_view(r, 1)); }
 
 } // namespace prelude
+
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<prelude::ints_view<T>> = true;
+template <> inline constexpr bool std::ranges::enable_borrowed_range<prelude::tokens_view> = true;
@@ -1,11 +1,39 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <numeric>
 #include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 #include <spdlog/spdlog.h>
 
+#include "prelude/aoc.hpp"
+#include "prelude/arena.hpp"
+#include "prelude/cache.hpp"
+#include "prelude/columnar.hpp"
+#include "prelude/gen.hpp"
+#include "prelude/grid.hpp"
+#include "prelude/hash.hpp"
+#include "prelude/input.hpp"
+#include "prelude/parallel.hpp"
+#include "prelude/perf.hpp"
 #include "prelude/prelude.hpp"
+#include "prelude/simd.hpp"
+#include "prelude/soa.hpp"
+#include "prelude/sort.hpp"
+#include "prelude/timing.hpp"
+#include "prelude/trace.hpp"
 
 TEST(PreludeTest, TestZip) {
     std::vector<int> v0 = {5, 4, 3, 2, 1, 0};
@@ -50,6 +78,753 @@ TEST(PreludeTest, TestPairwise) {
     ASSERT_EQ(count, expected.size());
 }
 
+TEST(PreludeTest, TestLines) {
+    auto collected = [](std::string_view text) {
+        return prelude::lines(text) | prelude::collect<std::vector>;
+    };
+    std::vector<std::string_view> expected{"one", "", "three"};
+    EXPECT_EQ(collected("one\n\nthree\n"), expected);
+    EXPECT_EQ(collected("one\n\nthree"), expected);
+    EXPECT_TRUE(collected("").empty());
+    EXPECT_EQ(collected("\n"), std::vector<std::string_view>{""});
+
+    static_assert(prelude::line_count("one\n\nthree\n") == 3);
+    static_assert(prelude::line_count("") == 0);
+    constexpr auto sums = prelude::map_lines<2>("1x2\n3x4\n5x6\n", [](std::string_view line) {
+        auto [a, b] = prelude::ints<2, int>(line);
+        return a + b;
+    });
+    static_assert(sums == std::array{3, 7});
+    EXPECT_THROW(prelude::map_lines<3>("1\n2\n", [](std::string_view line) { return line; }),
+                 std::invalid_argument);
+}
+
+TEST(PreludeTest, TestMappedInput) {
+    std::FILE *f = std::tmpfile();
+    ASSERT_NE(f, nullptr);
+    std::fputs("1x2x3\n4x5x6\n", f);
+    std::rewind(f);
+
+    const prelude::mapped_input input(fileno(f));
+    EXPECT_TRUE(input.mapped());
+    auto lines = input.lines() | prelude::collect<std::vector>;
+    ASSERT_EQ(lines.size(), 2);
+    EXPECT_EQ(lines[0], "1x2x3");
+    EXPECT_EQ(lines[1], "4x5x6");
+
+    // only what's left after a header's been read off
+    std::fseek(f, 6, SEEK_SET);
+    const prelude::mapped_input rest(fileno(f));
+    EXPECT_EQ(rest.text(), "4x5x6\n");
+    std::fseek(f, 0, SEEK_END);
+    EXPECT_EQ(prelude::mapped_input(fileno(f)).text(), "");
+    std::fclose(f);
+}
+
+TEST(PreludeTest, TestChunkLines) {
+    std::string text;
+    for (int i = 0; i < 1000; ++i) {
+        text += std::to_string(i * 7919) + "\n";
+    }
+    for (size_t n : {1, 2, 3, 7, 64, 5000}) {
+        auto chunks = prelude::chunk_lines(text, n);
+        EXPECT_LE(chunks.size(), n);
+        std::string joined;
+        for (auto c : chunks) {
+            EXPECT_EQ(c.back(), '\n');
+            joined += c;
+        }
+        EXPECT_EQ(joined, text);
+    }
+}
+
+TEST(PreludeTest, TestParLines) {
+    std::string text;
+    for (int i = 0; i < 10000; ++i) {
+        text += std::to_string(i) + "\n";
+    }
+    auto parsed = prelude::par_lines(
+        text, [](std::string_view line) { return std::stoi(std::string(line)); }, 64);
+    ASSERT_EQ(parsed.size(), 10000);
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_EQ(parsed[i], i);
+    }
+}
+
+TEST(PreludeTest, TestThreadPool) {
+    prelude::thread_pool pool(4);
+    std::vector<int> hits(1000, 0);
+    pool.parallel_for(hits.size(), [&](size_t i) { hits[i] += 1; });
+    EXPECT_TRUE(std::ranges::all_of(hits, [](int h) { return h == 1; }));
+
+    EXPECT_THROW(pool.parallel_for(10,
+                                   [](size_t i) {
+                                       if (i == 7) {
+                                           throw std::runtime_error("seven");
+                                       }
+                                   }),
+                 std::runtime_error);
+
+    // nested, from the workers themselves
+    std::vector<std::vector<int>> nested(8, std::vector<int>(100, 0));
+    pool.parallel_for(nested.size(), [&](size_t i) {
+        pool.parallel_for(nested[i].size(), [&](size_t j) { nested[i][j] += 1; });
+    });
+    for (const auto &row : nested) {
+        EXPECT_TRUE(std::ranges::all_of(row, [](int h) { return h == 1; }));
+    }
+
+    // A caller with nothing left to run sleeps, rather than spinning until
+    // the rest of its batch is done: here the task on the worker holds out
+    // until the caller, done with its own, has gone to sleep.
+    prelude::thread_pool pair(2);
+    const auto caller = std::this_thread::get_id();
+    std::atomic<bool> started{false};
+    bool parked = false;
+    pair.parallel_for(2, [&](size_t) {
+        if (std::this_thread::get_id() == caller) {
+            while (!started) {
+                std::this_thread::yield();
+            }
+            return;
+        }
+        started = true;
+        const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!(parked = pair.asleep() == 1) && std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    EXPECT_TRUE(parked);
+}
+
+TEST(PreludeTest, TestParReduce) {
+    std::vector<long> v(100000);
+    std::iota(v.begin(), v.end(), 1);
+    EXPECT_EQ(v | prelude::par_sum, 100000l * 100001 / 2);
+    EXPECT_EQ(v | rv::transform([](long x) { return x % 7; }) | prelude::par_sum,
+              v | rv::transform([](long x) { return x % 7; }) | prelude::sum);
+    EXPECT_EQ(std::vector<long>{} | prelude::par_sum, 0);
+    EXPECT_EQ(std::vector<long>({2, 3, 7}) | prelude::par_product, 42);
+
+    // string concatenation is associative but not commutative, so this only
+    // passes if the blocks get stitched back together in order.
+    std::vector<std::string> words;
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        words.push_back(std::to_string(i));
+        expected += words.back();
+    }
+    for (size_t threads : {1, 3, 8}) {
+        prelude::thread_pool pool(threads);
+        EXPECT_EQ(words | prelude::par_reduce(std::string{}, std::plus<>{}, pool), expected);
+    }
+}
+
+TEST(PreludeTest, TestInts) {
+    auto all = [](std::string_view s) { return prelude::ints(s) | prelude::collect<std::vector>; };
+    EXPECT_EQ(all("162,817,812"), (std::vector<long>{162, 817, 812}));
+    EXPECT_EQ(all("p=-3,14 v=2,-70"), (std::vector<long>{-3, 14, 2, -70}));
+    EXPECT_EQ(all("11-22,95-115"), (std::vector<long>{11, 22, 95, 115}));
+    EXPECT_EQ(all("no numbers here"), std::vector<long>{});
+    EXPECT_EQ(all(""), std::vector<long>{});
+
+    auto unsigned_ = prelude::ints<unsigned>("x=-3") | prelude::collect<std::vector>;
+    EXPECT_EQ(unsigned_, std::vector<unsigned>{3});
+
+    auto [l, w, h] = prelude::ints<3, int>("2x3x4");
+    EXPECT_EQ(l * w * h, 24);
+    EXPECT_THROW(prelude::ints<3>("1,2"), std::invalid_argument);
+    EXPECT_THROW((prelude::ints<1, short>("99999")), std::out_of_range);
+    EXPECT_EQ(prelude::ints<1>("-9223372036854775808")[0], std::numeric_limits<long>::min());
+
+    static_assert(prelude::ints<2, int>("12x34")[1] == 34);
+}
+
+TEST(PreludeTest, TestScan) {
+    auto turn = prelude::scan<"turn {} {},{} through {},{}", std::string_view, int, int, int, int>(
+        "turn off 499,499 through 500,500");
+    ASSERT_TRUE(turn);
+    EXPECT_EQ(*turn, std::make_tuple("off"sv, 499, 499, 500, 500));
+
+    EXPECT_FALSE((prelude::scan<"toggle {},{} through {},{}", int, int, int, int>(
+        "turn on 0,0 through 999,999")));
+    EXPECT_FALSE((prelude::scan<"{},{}", int, int>("1,2,3")));
+    EXPECT_FALSE((prelude::scan<"{},{}", int, int>("1,x")));
+
+    auto machine = prelude::scan<"[{}] {} {{{}}}">("[.##.] (3) (1,3) {3,5,4,7}");
+    ASSERT_TRUE(machine);
+    EXPECT_EQ(*machine, std::make_tuple(".##."sv, "(3) (1,3)"sv, "3,5,4,7"sv));
+
+    auto turn_dir = prelude::scan<"{}{}", char, int>("L-68");
+    ASSERT_TRUE(turn_dir);
+    EXPECT_EQ(*turn_dir, std::make_tuple('L', -68));
+
+    static_assert(prelude::scan<"{}x{}: {}", int, int, std::string_view>("12x5: 1 0 1")
+                  == std::make_tuple(12, 5, "1 0 1"sv));
+}
+
+TEST(PreludeTest, TestChomp) {
+    EXPECT_EQ(prelude::chomp("  hello world \t\n"), "hello world");
+    EXPECT_EQ(prelude::chomp("   \r\n"), "");
+    EXPECT_EQ(prelude::chomp(""), "");
+    static_assert(prelude::chomp(" x ") == "x");
+}
+
+TEST(PreludeTest, TestTokens) {
+    // long enough to go through the 16-byte path a few times
+    std::string line = "  123 328  51 64 \t 45\v64\f387\r23    6 98  215 314   *   +   *   +  ";
+    std::vector<std::string_view> expected{"123", "328", "51", "64", "45", "64", "387",
+                                           "23",  "6",   "98", "215", "314", "*", "+",
+                                           "*",   "+"};
+    EXPECT_EQ(prelude::split_ws(line), expected);
+    EXPECT_EQ(prelude::tokens(line) | prelude::collect<std::vector>, expected);
+    EXPECT_TRUE(prelude::split_ws(" \t\n ").empty());
+    EXPECT_EQ(std::ranges::distance(prelude::tokens("a")), 1);
+    static_assert(std::ranges::distance(prelude::tokens(" a bb  ccc ")) == 3);
+}
+
+TEST(PreludeTest, TestGrid) {
+    auto g = prelude::Grid<int>::from_lines(std::vector<std::string>{"123", "456"},
+                                            [](char ch) { return ch - '0'; }, 1);
+    EXPECT_EQ(g.rows(), 2);
+    EXPECT_EQ(g.cols(), 3);
+    EXPECT_EQ(g(1, 2), 6);
+    EXPECT_EQ(g(-1, -1), 0);
+    EXPECT_EQ(g(2, 3), 0);
+    EXPECT_EQ(g.neighbor_sum(0, 0), 2 + 4 + 5);
+    EXPECT_EQ(g.neighbor_sum(1, 1), 1 + 2 + 3 + 4 + 6);
+    EXPECT_EQ(g.count_neighbors(0, 1, 0), 3);
+    EXPECT_EQ(g.neighbors(1, 0), (std::array<int, 8>{0, 1, 2, 0, 5, 0, 0, 0}));
+    EXPECT_EQ(g.cells() | prelude::collect<std::vector>, (std::vector<int>{1, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(fmt::format("{}", g), "123\n456\n");
+
+    auto sums = g.stencil([](int r, int c, const auto &g) { return g.neighbor_sum(r, c); });
+    EXPECT_EQ(sums(0, 2), 2 + 5 + 6);
+
+    EXPECT_THROW(prelude::Grid<char>::from_lines(std::vector<std::string>{"ab", "c"},
+                                                 [](char ch) { return ch; }),
+                 std::invalid_argument);
+}
+
+TEST(PreludeTest, TestArena) {
+    prelude::arena arena;
+    auto rows = prelude::lines("1 2 3\n4 5\n") | rv::transform([&](std::string_view line) {
+                    return prelude::ints(line) | prelude::collect<prelude::pmr::vector>(arena);
+                })
+                | prelude::collect<prelude::pmr::vector>(arena);
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0], (prelude::pmr::vector<long>{1, 2, 3}));
+    EXPECT_EQ(rows[1], (prelude::pmr::vector<long>{4, 5}));
+    EXPECT_EQ(rows.get_allocator().resource(), arena.resource());
+    EXPECT_EQ(rows[1].get_allocator().resource(), arena.resource());
+
+    auto letters = prelude::tokens("b a b") | prelude::collect<prelude::pmr::set>(arena);
+    EXPECT_EQ(letters.size(), 2u);
+    EXPECT_EQ(letters.get_allocator().resource(), arena.resource());
+
+    auto g = prelude::pmr::Grid<char>::from_lines(
+        std::vector<std::string>{"ab", "cd"}, [](char ch) { return ch; }, 1, '.', arena.resource());
+    EXPECT_EQ(fmt::format("{}", g), "ab\ncd\n");
+
+    // a parse that takes a memory resource gets an arena that outlives it
+    auto parse = [](std::string_view text, std::pmr::memory_resource *mr) {
+        return prelude::ints(text) | prelude::collect<prelude::pmr::vector>(mr);
+    };
+    auto total = [](const prelude::pmr::vector<long> &v) { return v | prelude::sum; };
+    auto s = prelude::make_solution(2025, 3, parse, total, total);
+    EXPECT_EQ(prelude::solve(s, "1 2 3").part1, "6");
+}
+
+namespace {
+struct cell {
+    int x, y;
+    bool operator==(const cell &) const = default;
+};
+
+struct named {
+    std::string name;
+    bool flag = false;
+    bool operator==(const named &) const = default;
+    friend size_t hash_value(const named &n) { return prelude::hash_fields(n.name, n.flag); }
+};
+} // namespace
+
+TEST(PreludeTest, TestFlatMap) {
+    // against std::unordered_map, through enough inserts and erases to grow
+    // the table several times and exercise the backward shifts
+    prelude::flat_map<int, long> m;
+    std::unordered_map<int, long> want;
+    prelude::rng r(7);
+    for (int i = 0; i < 20000; ++i) {
+        const int k = r.uniform(0, 999);
+        if (r.chance(0.3)) {
+            EXPECT_EQ(m.erase(k), want.erase(k));
+        } else {
+            m[k] += i;
+            want[k] += i;
+        }
+    }
+    ASSERT_EQ(m.size(), want.size());
+    for (auto &[k, v] : want) {
+        ASSERT_TRUE(m.contains(k));
+        EXPECT_EQ(m.at(k), v);
+    }
+    long total = 0;
+    for (auto &[k, v] : m) {
+        total += v;
+    }
+    EXPECT_EQ(total, want | rv::values | prelude::sum);
+    EXPECT_THROW(m.at(-1), std::out_of_range);
+
+    prelude::flat_set<cell> cells{{0, 0}, {1, 2}, {0, 0}};
+    EXPECT_EQ(cells.size(), 2u);
+    EXPECT_TRUE(cells.contains({1, 2}));
+    EXPECT_FALSE(cells.contains({2, 1}));
+    EXPECT_FALSE(cells.insert({1, 2}).second);
+
+    // strings are looked up by string_view without making a std::string
+    prelude::flat_map<std::string, int> words;
+    words["apple"] = 1;
+    words.try_emplace(std::string_view("pear"), 2);
+    EXPECT_EQ(words.at(std::string_view("pear")), 2);
+    EXPECT_NE(words.find("apple"), words.end());
+    EXPECT_EQ(words.count("plum"), 0u);
+
+    prelude::flat_set<named> names;
+    names.insert({"a", true});
+    EXPECT_TRUE(names.contains({"a", true}));
+    EXPECT_FALSE(names.contains({"a", false}));
+    EXPECT_EQ(prelude::hash<named>{}({"a", true}), prelude::hash_fields(std::string("a"), true));
+
+    auto small = prelude::ints("3 1 3 2") | prelude::collect<prelude::flat_set>;
+    EXPECT_EQ(small.size(), 3u);
+}
+
+TEST(PreludeTest, TestSimd) {
+    namespace simd = prelude::simd;
+    using V = simd::vec<int8_t, 16>;
+    std::array<int8_t, 16> in{};
+    std::iota(in.begin(), in.end(), int8_t{-8});
+    const V v = V::load(in.data());
+    EXPECT_EQ(simd::count(v < 0), 8);
+    EXPECT_EQ(simd::count((v > -3) & (v < 3)), 5);
+    EXPECT_FALSE(simd::any(v > 7));
+    EXPECT_EQ(simd::reduce_add<int>(v + 1), 8);
+    EXPECT_EQ(simd::select(v == 0, V::splat(42), v)[8], 42);
+    std::vector<size_t> set;
+    simd::for_each_set((v & 3) == 0, [&](size_t i) { set.push_back(i); });
+    EXPECT_EQ(set, (std::vector<size_t>{0, 4, 8, 12}));
+
+    // every level this CPU has agrees with the scalar fallback, tail and all
+    std::string text(1000, '.');
+    prelude::rng r(3);
+    for (auto &ch : text) {
+        ch = r.pick(std::string_view("(.)"));
+    }
+    auto opens = []<size_t W>(std::string_view s) {
+        size_t i = 0;
+        long n = 0;
+        if constexpr (W > 0) {
+            using C = simd::vec<char, W>;
+            for (; i + W <= s.size(); i += W) {
+                n += simd::count(C::load(s.data() + i) == '(');
+            }
+        }
+        for (; i < s.size(); ++i) {
+            n += s[i] == '(';
+        }
+        return n;
+    };
+    const long want = std::ranges::count(text, '(');
+    for (auto l : {simd::level::scalar, simd::level::sse42, simd::level::avx2,
+                   simd::level::avx512}) {
+        if (l <= simd::detect()) {
+            EXPECT_EQ(simd::dispatch_at(l, opens, std::string_view(text).substr(1)),
+                      want - (text[0] == '('))
+                << simd::name(l);
+        }
+    }
+}
+
+TEST(PreludeTest, TestSoaVector) {
+    enum { X, Y, NAME };
+    prelude::soa_vector<long, double, std::string> rows;
+    rows.emplace_back(1, 0.5, "one");
+    rows.push_back({2, 1.5, "two"});
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows.field<X>()[1], 2);
+    EXPECT_EQ(rows.field<NAME>()[0], "one");
+
+    auto [x, y, name] = rows[1];
+    x = 20;
+    name += "!";
+    EXPECT_EQ(rows.field<X>()[1], 20);
+    EXPECT_EQ(rows[1], std::make_tuple(20, 1.5, "two!"));
+
+    // elements are references, even by value
+    for (auto [_, weight, __] : rows) {
+        weight *= 2;
+    }
+    EXPECT_EQ((rows.field<Y>() | prelude::sum), 4.0);
+    EXPECT_EQ(rows | rv::transform([](auto r) { return std::get<NAME>(r).size(); }) | prelude::sum,
+              7u);
+    static_assert(std::ranges::random_access_range<const decltype(rows) &>);
+
+    auto ints = [](std::string_view l) { return prelude::ints<2, int>(l); };
+    prelude::soa_vector<int, int> pairs(prelude::lines("1 2\n3 4\n") | rv::transform(ints));
+    EXPECT_EQ(pairs.size(), 2u);
+    EXPECT_EQ(pairs[1], std::make_tuple(3, 4));
+}
+
+TEST(PreludeTest, TestRadixSort) {
+    struct record {
+        int key;
+        size_t order;
+    };
+    prelude::rng r(8);
+    prelude::thread_pool pool(4);
+    // serial, parallel, and keys narrow enough to skip most passes
+    const int min = std::numeric_limits<int>::min(), max = std::numeric_limits<int>::max();
+    for (auto [n, lo, hi] : {std::tuple(1000, -500, 500), std::tuple(300000, min, max),
+                             std::tuple(300000, 0, 9)}) {
+        std::vector<record> v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back({r.uniform(lo, hi), v.size()});
+        }
+        auto want = v;
+        std::ranges::stable_sort(want, {}, &record::key);
+        prelude::radix_sort(v, &record::key, pool);
+        EXPECT_TRUE(std::ranges::equal(v, want, [](const record &a, const record &b) {
+            return a.key == b.key && a.order == b.order;
+        })) << n << " in [" << lo << ", " << hi << "]";
+    }
+
+    std::vector<uint64_t> words{5, 3, 1ull << 60, 3, 0};
+    prelude::radix_sort(words);
+    EXPECT_EQ(words, (std::vector<uint64_t>{0, 3, 3, 5, 1ull << 60}));
+
+    prelude::key_packer pack(1000, 99);
+    const uint64_t w = pack(1000, 42);
+    EXPECT_EQ(pack.key(w), 1000u);
+    EXPECT_EQ(pack.payload(w), 42u);
+    EXPECT_LT(pack(999, 99), pack(1000, 0));
+    EXPECT_THROW(prelude::key_packer(UINT64_MAX, 1), std::out_of_range);
+
+    // a 35-bit key (2025 day8's distances) and a 29-bit payload is exactly
+    // 64 bits; two 15-bit indices (16385 points or more) is one too many
+    const uint64_t distance = (uint64_t{1} << 35) - 1;
+    const uint64_t payload = (uint64_t{1} << 29) - 1;
+    EXPECT_TRUE(prelude::key_packer::fits(distance, payload));
+    const prelude::key_packer full(distance, payload);
+    EXPECT_EQ(full.key(full(distance, payload)), distance);
+    EXPECT_EQ(full.payload(full(distance, payload)), payload);
+    const uint64_t pair = (uint64_t{16384} << 15) | 16384;
+    EXPECT_FALSE(prelude::key_packer::fits(distance, pair));
+    EXPECT_THROW(prelude::key_packer(distance, pair), std::out_of_range);
+    EXPECT_FALSE(prelude::key_packer::fits(0, UINT64_MAX));
+}
+
+TEST(PreludeTest, TestSolution) {
+    auto parse = [](std::string_view text) {
+        return prelude::ints(text) | prelude::collect<std::vector>;
+    };
+    auto total = [](const std::vector<long> &v) { return v | prelude::sum; };
+    auto sorted = [](std::vector<long> v) { // takes its own copy and scribbles on it
+        std::ranges::sort(v);
+        return v.front();
+    };
+
+    auto s = prelude::make_solution(2015, 2, parse, total, sorted);
+    EXPECT_EQ(s.name(), "2015/day2");
+    auto a = prelude::solve(s, "3 1 2\n");
+    EXPECT_EQ(a.part1, "6");
+    EXPECT_EQ(a.part2, "1");
+
+    auto parsed = s.parse("5 4");
+    EXPECT_EQ(s.part2(parsed.get()), "4");
+    EXPECT_EQ(s.part1(parsed.get()), "9");
+
+    auto one = prelude::make_solution(2025, 12, parse, total);
+    EXPECT_FALSE(one.part2);
+    EXPECT_EQ(prelude::solve(one, "1 1").part1, "2");
+}
+
+TEST(PreludeTest, TestRng) {
+    prelude::rng a(42), b(42);
+    for (int i = 0; i < 1000; ++i) {
+        const long x = a.uniform(-3l, 3l);
+        EXPECT_EQ(x, b.uniform(-3l, 3l));
+        EXPECT_GE(x, -3);
+        EXPECT_LE(x, 3);
+    }
+    EXPECT_EQ(a.uniform(7, 7), 7);
+    EXPECT_THROW(a.uniform(1, 0), std::invalid_argument);
+
+    std::vector<int> v = {1, 2, 3, 4, 5};
+    a.shuffle(v);
+    std::ranges::sort(v);
+    EXPECT_EQ(v, (std::vector<int>{1, 2, 3, 4, 5}));
+}
+
+TEST(PreludeTest, TestGenArgs) {
+    const char *argv[] = {"gen", "--n=12", "--density=0.25"};
+    prelude::gen_args args(3, const_cast<char **>(argv), "test");
+    EXPECT_EQ(args.get("n", 5l, "n"), 12);
+    EXPECT_EQ(args.get("density", 0.5, "density"), 0.25);
+    EXPECT_EQ(args.get("rows", 3, "rows"), 3);
+    EXPECT_NO_THROW(args.done());
+
+    const char *bad[] = {"gen", "--n=twelve", "--m=1"};
+    prelude::gen_args bad_args(3, const_cast<char **>(bad), "test");
+    EXPECT_EQ(bad_args.get("n", 5l, "n"), 5);
+    EXPECT_THROW(bad_args.done(), prelude::gen_args::usage);
+}
+
+TEST(PreludeTest, TestTiming) {
+    prelude::timings off;
+    { prelude::scoped_timer t("ignored", off); }
+    EXPECT_TRUE(off.phases().empty());
+
+    prelude::timings t;
+    t.enable("/dev/null");
+    t.annotate("solution", "2015/day\"1\"");
+    for (int i = 0; i < 2; ++i) {
+        prelude::scoped_timer outer("outer", t);
+        prelude::scoped_timer inner("inner", t);
+    }
+    auto phases = t.phases();
+    ASSERT_EQ(phases.size(), 2);
+    EXPECT_EQ(phases[0].name, "outer/inner");
+    EXPECT_EQ(phases[1].name, "outer");
+    EXPECT_EQ(phases[1].count, 2);
+    EXPECT_GE(phases[1].wall, phases[0].wall);
+
+    auto json = t.json();
+    EXPECT_NE(json.find("\"solution\": \"2015/day\\\"1\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\": \"outer/inner\", \"count\": 2"), std::string::npos);
+
+    // a top-level timer ignores what's running around it, and puts it back after
+    {
+        prelude::scoped_timer outer("outer", t);
+        {
+            prelude::scoped_timer task(prelude::scoped_timer::top_level, "task", t);
+            prelude::scoped_timer inner("inner", t);
+        }
+        prelude::scoped_timer after("after", t);
+    }
+    auto names = t.phases() | rv::transform(&prelude::timings::phase::name)
+                 | prelude::collect<std::vector>;
+    EXPECT_EQ(names, (std::vector<std::string>{"outer/inner", "outer", "task/inner", "task",
+                                               "outer/after"}));
+}
+
+TEST(PreludeTest, TestPerf) {
+    // Whatever this machine allows: counters that didn't open read 0 and
+    // say why, the ones that did only go up.
+    prelude::perf_counters counters;
+    auto before = counters.read();
+    std::vector<long> v(1 << 16, 1);
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0l), 1 << 16);
+    auto after = counters.read();
+    for (size_t i = 0; i < prelude::perf_events.size(); ++i) {
+        if (counters.available(i)) {
+            EXPECT_GE(after[i], before[i]) << prelude::perf_events[i].name;
+        } else {
+            EXPECT_EQ(after[i], 0) << prelude::perf_events[i].name;
+            EXPECT_FALSE(counters.error().empty());
+        }
+    }
+}
+
+TEST(PreludeTest, TestTrace) {
+    prelude::tracer off;
+    { prelude::trace_span s("ignored", off); }
+    EXPECT_EQ(off.json().find("ignored"), std::string::npos);
+
+    prelude::tracer t;
+    t.enable("/dev/null");
+    {
+        prelude::trace_span outer("outer", t);
+        std::jthread([&t] { prelude::trace_span s("work", "item", 7, t); }).join();
+    }
+    auto json = t.json();
+    EXPECT_NE(json.find("\"name\": \"outer\", \"ph\": \"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\": \"work\", \"ph\": \"X\""), std::string::npos);
+    // one buffer, and one thread_name record, per thread
+    EXPECT_NE(json.find("\"args\": {\"name\": \"thread 1\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"args\": {\"item\": 7}"), std::string::npos);
+}
+
+TEST(PreludeTest, TestReadaheadLines) {
+    auto read_through_pipe = [](std::string text, size_t block_size) {
+        int fds[2];
+        EXPECT_EQ(::pipe(fds), 0);
+        std::jthread writer([&text, fd = fds[1]] {
+            // in dribs and drabs, so lines arrive in pieces
+            for (size_t i = 0; i < text.size(); i += 5) {
+                EXPECT_GT(::write(fd, text.data() + i, std::min<size_t>(5, text.size() - i)), 0);
+            }
+            ::close(fd);
+        });
+        std::vector<std::string> lines;
+        {
+            prelude::readahead_lines in(fds[0], block_size, 2);
+            for (std::string_view line : in) {
+                lines.emplace_back(line);
+            }
+        }
+        ::close(fds[0]);
+        return lines;
+    };
+    using V = std::vector<std::string>;
+
+    // lines longer than a block, and shorter, straddling blocks or not
+    const std::string text = "short\na line that is much longer than a block\n\nx\nlast";
+    const V want{"short", "a line that is much longer than a block", "", "x", "last"};
+    for (size_t block_size : {1, 3, 7, 64, 4096}) {
+        EXPECT_EQ(read_through_pipe(text, block_size), want) << block_size;
+        EXPECT_EQ(read_through_pipe(text + "\n", block_size), want) << block_size;
+    }
+    EXPECT_EQ(read_through_pipe("", 7), V{});
+    EXPECT_EQ(read_through_pipe("\n", 7), V{""});
+
+    // gone before reading it all, with the writer still going
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    {
+        prelude::readahead_lines in(fds[0], 16, 2);
+        ASSERT_EQ(::write(fds[1], "one\ntwo\n", 8), 8);
+        EXPECT_EQ(*in.begin(), "one");
+    }
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST(PreludeTest, TestColumnar) {
+    prelude::soa_vector<long, double, uint8_t> rows;
+    rows.emplace_back(1, 0.5, 7);
+    rows.emplace_back(-2, 1.5, 8);
+    const std::vector<std::vector<short>> ragged{{1, 2}, {}, {3}};
+
+    prelude::column_writer out;
+    out.soa(rows);
+    out.ragged(ragged);
+    out.value(42u);
+    const auto bytes = out.bytes(2025, 8, 3);
+    EXPECT_TRUE(prelude::is_columnar(bytes));
+    EXPECT_FALSE(prelude::is_columnar("1,2,3\n"));
+
+    prelude::column_reader in(bytes, 2025, 8, 3);
+    auto back = in.soa<long, double, uint8_t>();
+    ASSERT_EQ(back.size(), 2);
+    EXPECT_EQ(back[0], std::tuple(1, 0.5, 7));
+    EXPECT_EQ(back[1], std::tuple(-2, 1.5, 8));
+    auto rows_back = in.ragged<short>();
+    ASSERT_EQ(rows_back.size(), 3);
+    EXPECT_EQ(std::vector<short>(rows_back[0].begin(), rows_back[0].end()), ragged[0]);
+    EXPECT_TRUE(rows_back[1].empty());
+    EXPECT_EQ(rows_back[2][0], 3);
+    EXPECT_EQ(in.value<unsigned>(), 42u);
+    EXPECT_THROW(in.column<long>(), std::runtime_error);
+
+    // another day, another version, the wrong type, or cut short
+    EXPECT_THROW(prelude::column_reader(bytes, 2025, 9, 3), std::runtime_error);
+    EXPECT_THROW(prelude::column_reader(bytes, 2025, 8, 4), std::runtime_error);
+    prelude::column_reader wrong(bytes, 2025, 8, 3);
+    EXPECT_THROW(wrong.column<int>(), std::runtime_error);
+    prelude::column_reader cut(std::string_view(bytes).substr(0, 200), 2025, 8, 3);
+    EXPECT_THROW((cut.soa<long, double, uint8_t>()), std::runtime_error);
+}
+
+TEST(PreludeTest, TestAnswerCache) {
+    const auto dir = std::filesystem::temp_directory_path()
+                     / fmt::format("prelude_test_cache.{}", ::getpid());
+    std::filesystem::remove_all(dir);
+    int solves = 0;
+    auto s = prelude::make_solution(
+        2015, 1,
+        [&solves](std::string_view text) {
+            ++solves;
+            return std::string(text);
+        },
+        [](const std::string &text) { return text.size(); },
+        [](const std::string &text) { return text + "\n!"; });
+
+    {
+        prelude::answer_cache cache(dir);
+        EXPECT_FALSE(cache.lookup(s, "abc"));
+        prelude::solve(s, "abc", &cache);
+        auto a = prelude::solve(s, "abc", &cache);
+        EXPECT_EQ(solves, 1);
+        EXPECT_EQ(a.part1, "3");
+        EXPECT_EQ(a.part2, "abc\n!");
+
+        // another input, or another version of the day, is a miss
+        EXPECT_FALSE(cache.lookup(s, "abd"));
+        s.version = 2;
+        EXPECT_FALSE(cache.lookup(s, "abc"));
+        s.version = 1;
+    }
+    std::filesystem::remove_all(dir);
+
+    // Every file in dir a minute older, so the order of stores and hits
+    // doesn't hang on how finely the filesystem keeps time.
+    const auto age = [&dir] {
+        for (const auto &e : std::filesystem::directory_iterator(dir)) {
+            std::filesystem::last_write_time(e.path(),
+                                             e.last_write_time() - std::chrono::minutes(1));
+        }
+    };
+    const auto count = [&dir] {
+        return std::distance(std::filesystem::directory_iterator(dir),
+                             std::filesystem::directory_iterator());
+    };
+
+    // room for four entries: going over trims the least recently used down to three
+    prelude::answer_cache sizing(dir);
+    sizing.store(s, "x1", {"1", "2"});
+    const auto entry_bytes = std::filesystem::directory_iterator(dir)->file_size();
+    prelude::answer_cache small(dir, 4 * entry_bytes);
+    for (auto text : {"x2", "x3", "x4"}) {
+        age();
+        small.store(s, text, {"1", "2"});
+    }
+    age();
+    EXPECT_TRUE(small.lookup(s, "x1"));
+    age();
+    small.store(s, "x5", {"1", "2"});
+    EXPECT_EQ(count(), 3);
+    EXPECT_TRUE(small.lookup(s, "x1"));
+    EXPECT_FALSE(small.lookup(s, "x2"));
+    EXPECT_FALSE(small.lookup(s, "x3"));
+    EXPECT_TRUE(small.lookup(s, "x4"));
+    EXPECT_TRUE(small.lookup(s, "x5"));
+    std::filesystem::remove_all(dir);
+
+    // and likewise for the number of entries, however small they are
+    prelude::answer_cache few(dir, prelude::answer_cache::default_max_bytes, 4);
+    for (auto text : {"y1", "y2", "y3", "y4", "y5"}) {
+        age();
+        few.store(s, text, {"1", "2"});
+    }
+    EXPECT_EQ(count(), 3);
+    EXPECT_FALSE(few.lookup(s, "y2"));
+    EXPECT_TRUE(few.lookup(s, "y3"));
+
+    // a writer's temporary file is left alone, unless it's been there an hour
+    for (auto name : {".fresh.1.2", ".stale.1.2"}) {
+        std::ofstream(dir / name) << "half an entry";
+    }
+    std::filesystem::last_write_time(dir / ".stale.1.2",
+                                     std::filesystem::file_time_type::clock::now()
+                                         - std::chrono::hours(2));
+    prelude::answer_cache reopened(dir);
+    EXPECT_TRUE(std::filesystem::exists(dir / ".fresh.1.2"));
+    EXPECT_FALSE(std::filesystem::exists(dir / ".stale.1.2"));
+    EXPECT_TRUE(reopened.lookup(s, "y5"));
+    std::filesystem::remove_all(dir);
+}
+
 // TEST(PreludeTest, TestCombinations) {
 //     std::vector<int> stuff = {1, 2, 3, 4};
 //     std::vector<std::tuple<int, int>> expected{{1, 2}, {1, 3}, {1, 4}, {2, 3}, {2, 4}, {3, 4}};
@@ -0,0 +1,344 @@
+// main() for aoc_server, which has every day linked in and answers for any of
+// them over a Unix socket. A request pays for neither a process starting up
+// nor a day's setup: whatever a day keeps in a thread_local (2025 day10's z3
+// contexts) is made once per thread and stays made.
+//
+//     aoc_server [--socket=PATH] [--workers=N] [--cache=DIR]
+//
+// A request is a line naming the day and how many bytes of input follow,
+// then the input:
+//
+//     2025/day8 16067\n<16067 bytes>
+//
+// and the reply is one line of JSON, like a day binary's batch mode gives:
+//
+//     {"day": "2025/day8", "part1": "123", "part2": "456"}
+//     {"day": "2025/day8", "error": "..."}
+//
+// A connection can carry any number of requests, answered in order; a
+// request line that doesn't parse gets an error and the connection closed.
+// Each of the N workers (one per core by default) serves one connection at a
+// time, so a client shouldn't hold one open while it's idle; the days still
+// spread their own work over the shared pool. SIGINT or SIGTERM removes the
+// socket and exits. From a shell:
+//
+//     { echo "2025/day8 $(stat -c%s in.txt)"; cat in.txt; } | socat - UNIX:/tmp/aoc.sock
+//
+// The days trust their input to be a puzzle's, so the server is for trusted
+// clients on this machine only: the socket is made readable and writable by
+// its owner alone, and it mustn't be forwarded anywhere anyone else can reach
+// it. What it will take is limited all the same: inputs up to 64MB, as text,
+// since a columnar file (columnar.hpp) is read as it stands and only checked
+// as far as each day's loader goes.
+//
+// --cache (or $AOC_CACHE) is the answer cache, as for a single day.
+
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "prelude/aoc.hpp"
+#include "prelude/cache.hpp"
+#include "prelude/columnar.hpp"
+#include "prelude/parallel.hpp"
+#include "prelude/timing.hpp"
+
+namespace {
+
+constexpr size_t max_request_line = 256;
+// Puzzle inputs are tens of kilobytes; generated ones a few megabytes.
+constexpr size_t max_input = size_t{64} << 20;
+
+// Where the socket is, for stop() to remove it.
+char socket_path[sizeof(sockaddr_un::sun_path)];
+
+void stop(int) {
+    ::unlink(socket_path);
+    ::_exit(0);
+}
+
+// One client: buffered reads, and whole writes.
+class connection {
+    int _fd;
+    std::string _buf;
+    size_t _pos = 0; // _buf before this has been read
+    bool _too_long = false;
+
+    // Some more bytes onto _buf; false at end of file or on an error.
+    bool fill() {
+        char chunk[64 << 10];
+        ssize_t n;
+        do {
+            n = ::read(_fd, chunk, sizeof(chunk));
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) {
+            return false;
+        }
+        _buf.erase(0, _pos);
+        _pos = 0;
+        _buf.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+  public:
+    explicit connection(int fd) : _fd(fd) {}
+    ~connection() { ::close(_fd); }
+    connection(const connection &) = delete;
+    connection &operator=(const connection &) = delete;
+
+    // Whether the last line() came back empty for being longer than its max,
+    // rather than for the connection ending.
+    bool too_long() const { return _too_long; }
+
+    // The next line, without its '\n'. Nothing at the end, even partway
+    // through a line, or if the line is longer than max.
+    std::optional<std::string> line(size_t max) {
+        _too_long = false;
+        while (true) {
+            if (auto nl = _buf.find('\n', _pos); nl != std::string::npos) {
+                if (nl - _pos > max) {
+                    _too_long = true;
+                    return std::nullopt;
+                }
+                std::string l = _buf.substr(_pos, nl - _pos);
+                _pos = nl + 1;
+                return l;
+            }
+            if (_buf.size() - _pos > max) {
+                _too_long = true;
+                return std::nullopt;
+            }
+            if (!fill()) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    // The next n bytes; nothing if the connection ends first.
+    std::optional<std::string> bytes(size_t n) {
+        while (_buf.size() - _pos < n) {
+            if (!fill()) {
+                return std::nullopt;
+            }
+        }
+        std::string b = _buf.substr(_pos, n);
+        _pos += n;
+        return b;
+    }
+
+    bool write(std::string_view s) {
+        while (!s.empty()) {
+            ssize_t n = ::send(_fd, s.data(), s.size(), MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            s.remove_prefix(static_cast<size_t>(n));
+        }
+        return true;
+    }
+};
+
+// "2025/day8 16067" -> the day and the input's size.
+std::optional<std::pair<std::string, size_t>> parse_request(std::string_view line) {
+    auto space = line.find(' ');
+    if (space == std::string_view::npos) {
+        return std::nullopt;
+    }
+    auto size = line.substr(space + 1);
+    size_t n = 0;
+    auto [end, ec] = std::from_chars(size.data(), size.data() + size.size(), n);
+    if (ec != std::errc() || end != size.data() + size.size() || n > max_input) {
+        return std::nullopt;
+    }
+    return std::pair(std::string(line.substr(0, space)), n);
+}
+
+std::string error_reply(std::string_view day, std::string_view error) {
+    using prelude::detail::json_string;
+    return fmt::format("{{\"day\": {}, \"error\": {}}}\n", json_string(day), json_string(error));
+}
+
+using day_map = std::map<std::string, const prelude::solution *, std::less<>>;
+
+std::string reply(const day_map &days, const std::string &day, std::string_view text,
+                  const prelude::answer_cache *cache) {
+    using prelude::detail::json_string;
+    auto it = days.find(day);
+    if (it == days.end()) {
+        return error_reply(day, "no such day");
+    }
+    if (prelude::is_columnar(text)) {
+        return error_reply(day, "columnar input is only taken from files, not over the socket");
+    }
+    const auto &s = *it->second;
+    try {
+        auto answers = prelude::solve(s, text, cache);
+        std::string r = fmt::format("{{\"day\": {}, \"part1\": {}", json_string(day),
+                                    json_string(answers.part1));
+        if (s.part2) {
+            r += fmt::format(", \"part2\": {}", json_string(answers.part2));
+        }
+        return r + "}\n";
+    } catch (const std::exception &e) {
+        return error_reply(day, e.what());
+    }
+}
+
+void serve(int fd, const day_map &days, const prelude::answer_cache *cache) {
+    connection c(fd);
+    while (true) {
+        auto line = c.line(max_request_line);
+        if (!line) {
+            if (c.too_long()) {
+                c.write(error_reply("", "request line too long"));
+            }
+            return;
+        }
+        auto request = parse_request(*line);
+        if (!request) {
+            c.write(error_reply("", fmt::format("bad request line: {}", *line)));
+            return;
+        }
+        auto input = c.bytes(request->second);
+        if (!input || !c.write(reply(days, request->first, *input, cache))) {
+            return;
+        }
+    }
+}
+
+// A socket listening at path, or -1 having said why not.
+int listen_at(const std::string &path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        spdlog::error("socket path too long: {}", path);
+        return -1;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    auto *sa = reinterpret_cast<const sockaddr *>(&addr);
+
+    // A socket file nobody answers on is left over from a server that died.
+    if (const int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0); probe >= 0) {
+        const bool taken = ::connect(probe, sa, sizeof(addr)) == 0;
+        ::close(probe);
+        if (taken) {
+            spdlog::error("already serving on {}", path);
+            return -1;
+        }
+    }
+    ::unlink(path.c_str());
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        spdlog::error("socket: {}", std::strerror(errno));
+        return -1;
+    }
+    // bind() makes the socket file with the umask's permissions, so it's
+    // owner-only from the start rather than after a chmod. The umask is the
+    // process's, but no other thread has started yet.
+    const mode_t mask = ::umask(0177);
+    const bool bound = ::bind(fd, sa, sizeof(addr)) == 0;
+    ::umask(mask);
+    if (!bound || ::listen(fd, SOMAXCONN) < 0) {
+        spdlog::error("{}: {}", path, std::strerror(errno));
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string path = "/tmp/aoc.sock";
+    size_t workers = prelude::thread_count();
+    std::optional<std::string> cache_dir;
+    if (const char *env = std::getenv("AOC_CACHE"); env && *env) {
+        cache_dir = env;
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--socket=")) {
+            path = arg.substr(9);
+        } else if (arg.starts_with("--workers=")) {
+            auto n = arg.substr(10);
+            auto [end, ec] = std::from_chars(n.data(), n.data() + n.size(), workers);
+            if (ec != std::errc() || end != n.data() + n.size() || workers == 0) {
+                spdlog::error("--workers wants a positive number, not {}", n);
+                return 1;
+            }
+        } else if (arg.starts_with("--cache=")) {
+            cache_dir = arg.substr(8);
+        } else {
+            spdlog::error("usage: {} [--socket=PATH] [--workers=N] [--cache=DIR]", argv[0]);
+            spdlog::error("only for trusted local clients: don't expose the socket to others");
+            return 1;
+        }
+    }
+
+    day_map days;
+    for (const auto &s : prelude::registry()) {
+        days.emplace(s.name(), &s);
+    }
+
+    std::optional<prelude::answer_cache> cache;
+    if (cache_dir) {
+        try {
+            cache.emplace(*cache_dir);
+        } catch (const std::exception &e) {
+            spdlog::warn("not caching answers: {}", e.what());
+        }
+    }
+    const prelude::answer_cache *cache_ptr = cache ? &*cache : nullptr;
+
+    const int fd = listen_at(path);
+    if (fd < 0) {
+        return 1;
+    }
+    std::memcpy(socket_path, path.c_str(), path.size() + 1);
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+    // Built now rather than on the first request.
+    prelude::default_pool();
+    spdlog::info("serving {} days on {} with {} workers", days.size(), path, workers);
+
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < workers; ++i) {
+        threads.emplace_back([&] {
+            while (true) {
+                const int client = ::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client >= 0) {
+                    serve(client, days, cache_ptr);
+                } else if (errno != EINTR && errno != ECONNABORTED) {
+                    // Out of descriptors, most likely: give the others a
+                    // moment to finish with theirs.
+                    spdlog::warn("accept: {}", std::strerror(errno));
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Data-parallel kernels written once and run at the widest vectors the CPU
+// has, chosen at runtime, so one binary is fast on every host without
+// -march=native.
+//
+// A kernel is a generic lambda over W, the vector width in bytes. W is 0 for
+// the scalar fallback, so the vector loop goes under if constexpr (W > 0)
+// and a scalar loop finishes off whatever it leaves:
+//
+//     long opens = prelude::simd::dispatch([]<size_t W>(std::string_view s) {
+//         size_t i = 0;
+//         long n = 0;
+//         if constexpr (W > 0) {
+//             using V = prelude::simd::vec<char, W>;
+//             for (; i + W <= s.size(); i += W) {
+//                 n += prelude::simd::count(V::load(s.data() + i) == '(');
+//             }
+//         }
+//         for (; i < s.size(); ++i) {
+//             n += s[i] == '(';
+//         }
+//         return n;
+//     }, text);
+//
+// On x86 dispatch compiles the kernel for SSE4.2 (W = 16), AVX2 (32) and
+// AVX-512 (64) and calls the best one this CPU runs; elsewhere it's the
+// scalar fallback. $AOC_SIMD=scalar|sse4.2|avx2|avx512 caps the level, for
+// comparing them.
+//
+// vec<T, W> wraps a GCC/Clang extension vector (in .v, for anything not
+// covered here) with the usual arithmetic and bitwise operators, against
+// vectors or scalars. Comparisons give a mask: a vec of same-sized signed
+// lanes, all ones where true.
+
+namespace prelude::simd {
+
+enum class level { scalar, sse42, avx2, avx512 };
+
+constexpr std::string_view name(level l) {
+    switch (l) {
+    case level::sse42:
+        return "sse4.2";
+    case level::avx2:
+        return "avx2";
+    case level::avx512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+// Vector width in bytes at l; 0 for scalar.
+constexpr size_t width(level l) {
+    switch (l) {
+    case level::sse42:
+        return 16;
+    case level::avx2:
+        return 32;
+    case level::avx512:
+        return 64;
+    default:
+        return 0;
+    }
+}
+
+// The best level this CPU supports.
+inline level detect() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+        && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+        return level::avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2")) {
+        return level::avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+        return level::sse42;
+    }
+#endif
+    return level::scalar;
+}
+
+// The level dispatch uses: detect(), capped by $AOC_SIMD.
+inline level current() {
+    static const level l = [] {
+        level best = detect();
+        if (const char *env = std::getenv("AOC_SIMD"); env && *env) {
+            for (level cap : {level::scalar, level::sse42, level::avx2, level::avx512}) {
+                if (name(cap) == env && cap < best) {
+                    best = cap;
+                }
+            }
+        }
+        return best;
+    }();
+    return l;
+}
+
+namespace detail {
+template <typename T, size_t W> struct native {
+    typedef T type __attribute__((vector_size(W)));
+};
+
+// What comparing two T gives per lane.
+template <typename T> auto mask_lane_of() {
+    typename native<T, 16>::type a{};
+    return (a == a)[0];
+}
+template <typename T> using mask_lane = decltype(mask_lane_of<T>());
+
+template <size_t N> struct uint_of;
+template <> struct uint_of<1> {
+    using type = uint8_t;
+};
+template <> struct uint_of<2> {
+    using type = uint16_t;
+};
+template <> struct uint_of<4> {
+    using type = uint32_t;
+};
+template <> struct uint_of<8> {
+    using type = uint64_t;
+};
+} // namespace detail
+
+// W bytes' worth of T. A struct rather than the bare extension vector so it
+// can be passed and returned from code compiled without AVX.
+template <typename T, size_t W> struct vec {
+    using native_type = typename detail::native<T, W>::type;
+    // Bitwise ops go through unsigned lanes: GCC otherwise scalarizes & and
+    // | of two comparisons once they're inlined into AVX-512 code.
+    using bits_type = typename detail::native<typename detail::uint_of<sizeof(T)>::type, W>::type;
+    using mask_type = vec<detail::mask_lane<T>, W>;
+    static constexpr size_t size = W / sizeof(T);
+
+    native_type v;
+
+    // Unaligned.
+    static vec load(const void *p) {
+        vec r;
+        std::memcpy(&r.v, p, W);
+        return r;
+    }
+    void store(void *p) const { std::memcpy(p, &v, W); }
+
+    static vec splat(T x) { return {native_type{} + x}; }
+
+    T operator[](size_t i) const { return v[i]; }
+
+#define AOC_SIMD_BINARY(op)                                                                        \
+    friend vec operator op(const vec &a, const vec &b) { return {a.v op b.v}; }                    \
+    friend vec operator op(const vec &a, T b) { return {a.v op b}; }                               \
+    vec &operator op##=(const vec & b) { return v = v op b.v, *this; }
+#define AOC_SIMD_BITWISE(op)                                                                       \
+    friend vec operator op(const vec &a, const vec &b) {                                           \
+        return {(native_type)((bits_type)a.v op(bits_type) b.v)};                                  \
+    }                                                                                              \
+    friend vec operator op(const vec &a, T b) { return a op splat(b); }                            \
+    vec &operator op##=(const vec & b) { return *this = *this op b; }
+#define AOC_SIMD_COMPARE(op)                                                                       \
+    friend mask_type operator op(const vec &a, const vec &b) { return {a.v op b.v}; }              \
+    friend mask_type operator op(const vec &a, T b) { return {a.v op b}; }
+
+    AOC_SIMD_BINARY(+)
+    AOC_SIMD_BINARY(-)
+    AOC_SIMD_BINARY(*)
+    AOC_SIMD_BITWISE(&)
+    AOC_SIMD_BITWISE(|)
+    AOC_SIMD_BITWISE(^)
+    AOC_SIMD_COMPARE(==)
+    AOC_SIMD_COMPARE(!=)
+    AOC_SIMD_COMPARE(<)
+    AOC_SIMD_COMPARE(<=)
+    AOC_SIMD_COMPARE(>)
+    AOC_SIMD_COMPARE(>=)
+
+#undef AOC_SIMD_BINARY
+#undef AOC_SIMD_BITWISE
+#undef AOC_SIMD_COMPARE
+
+    friend vec operator~(const vec &a) { return {(native_type)~(bits_type)a.v}; }
+};
+
+namespace detail {
+template <typename T, size_t W> std::array<uint64_t, W / 8> words(const vec<T, W> &m) {
+    std::array<uint64_t, W / 8> w;
+    std::memcpy(w.data(), &m.v, W);
+    return w;
+}
+} // namespace detail
+
+// Lanes of a where mask m is set, b elsewhere.
+template <typename M, typename T, size_t W>
+vec<T, W> select(const vec<M, W> &m, const vec<T, W> &a, const vec<T, W> &b) {
+    using N = typename vec<T, W>::native_type;
+    using B = typename vec<T, W>::bits_type;
+    return {(N)(((B)a.v & (B)m.v) | ((B)b.v & ~(B)m.v))};
+}
+
+// Whether any lane of mask m is set.
+template <typename M, size_t W> bool any(const vec<M, W> &m) {
+    uint64_t x = 0;
+    for (uint64_t w : detail::words(m)) {
+        x |= w;
+    }
+    return x != 0;
+}
+
+// How many lanes of mask m are set.
+template <typename M, size_t W> long count(const vec<M, W> &m) {
+    long bits = 0;
+    for (uint64_t w : detail::words(m)) {
+        bits += std::popcount(w);
+    }
+    return bits / (8 * sizeof(M));
+}
+
+// f(i) for every lane i set in mask m, in order.
+template <typename M, size_t W, typename F> void for_each_set(const vec<M, W> &m, F f) {
+    constexpr size_t lane_bits = 8 * sizeof(M);
+    constexpr uint64_t lane_mask = lane_bits == 64 ? ~0ull : (1ull << lane_bits) - 1;
+    const auto w = detail::words(m);
+    for (size_t i = 0; i < w.size(); ++i) {
+        for (uint64_t x = w[i]; x;) {
+            const int bit = std::countr_zero(x);
+            f(i * (64 / lane_bits) + bit / lane_bits);
+            x &= ~(lane_mask << bit);
+        }
+    }
+}
+
+// Sum of the lanes of v, as R.
+template <typename R, typename T, size_t W> R reduce_add(const vec<T, W> &v) {
+    R sum = 0;
+    for (size_t i = 0; i < vec<T, W>::size; ++i) {
+        sum += v[i];
+    }
+    return sum;
+}
+
+#if defined(__x86_64__)
+// One trampoline per level. flatten inlines the kernel (and everything it
+// calls) into it, so all of it is compiled for that instruction set.
+namespace detail {
+template <typename F, typename... A>
+__attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx2,bmi,bmi2,popcnt"), flatten))
+decltype(auto) run_avx512(F &f, A &&...a) {
+    return f.template operator()<64>(std::forward<A>(a)...);
+}
+
+template <typename F, typename... A>
+__attribute__((target("avx2,bmi,bmi2,popcnt"), flatten)) decltype(auto) run_avx2(F &f, A &&...a) {
+    return f.template operator()<32>(std::forward<A>(a)...);
+}
+
+template <typename F, typename... A>
+__attribute__((target("sse4.2,popcnt"), flatten)) decltype(auto) run_sse42(F &f, A &&...a) {
+    return f.template operator()<16>(std::forward<A>(a)...);
+}
+} // namespace detail
+#endif
+
+// f.operator()<W>(a...) at level l, which the CPU has to support.
+template <typename F, typename... A> decltype(auto) dispatch_at(level l, F &&f, A &&...a) {
+#if defined(__x86_64__)
+    switch (l) {
+    case level::avx512:
+        return detail::run_avx512(f, std::forward<A>(a)...);
+    case level::avx2:
+        return detail::run_avx2(f, std::forward<A>(a)...);
+    case level::sse42:
+        return detail::run_sse42(f, std::forward<A>(a)...);
+    default:
+        break;
+    }
+#else
+    (void)l;
+#endif
+    return f.template operator()<0>(std::forward<A>(a)...);
+}
+
+// f.operator()<W>(a...) at the current() level.
+template <typename F, typename... A> decltype(auto) dispatch(F &&f, A &&...a) {
+    return dispatch_at(current(), std::forward<F>(f), std::forward<A>(a)...);
+}
+
+} // namespace prelude::simd
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Records stored a field at a time: soa_vector<long, long, long> keeps every
+// x in one vector, every y in another, and so on. A scan over one field reads
+// only that field, and a loop over a few of them reads plain parallel arrays
+// that the compiler or simd.hpp can vectorize.
+//
+// field<I>() is field I as a span; an unscoped enum names them:
+//
+//     enum { X, Y, Z };
+//     prelude::soa_vector<long, long, long> points;
+//     points.emplace_back(1, 2, 3);
+//     long left = std::ranges::min(points.field<X>());
+//
+// The container itself is a random-access range of std::tuple<Ts &...>, so
+// structured bindings and the range adaptors work as they would on a vector
+// of structs. It can't go through std::sort, though (the elements are
+// proxies); sort a field, or a vector of indices.
+//
+// No bool fields: std::vector<bool> isn't contiguous. Use char or uint8_t.
+
+namespace prelude {
+
+template <typename... Ts> class soa_vector {
+    static_assert(sizeof...(Ts) > 0);
+    static_assert((!std::is_same_v<Ts, bool> && ...), "use char or uint8_t instead of bool");
+
+    std::tuple<std::vector<Ts>...> _fields;
+
+    template <bool Const> class iterator_base {
+        template <typename T> using field_ptr = std::conditional_t<Const, const T *, T *>;
+
+        std::tuple<field_ptr<Ts>...> _base;
+        std::ptrdiff_t _i = 0;
+
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::tuple<Ts...>;
+        using reference = std::tuple<std::conditional_t<Const, const Ts &, Ts &>...>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator_base() = default;
+        iterator_base(std::tuple<field_ptr<Ts>...> base, std::ptrdiff_t i) : _base(base), _i(i) {}
+        // iterator -> const_iterator
+        template <bool C = Const>
+            requires C
+        iterator_base(const iterator_base<false> &o) : _base(o._base), _i(o._i) {}
+
+        reference operator*() const {
+            return std::apply([i = _i](auto *...p) { return reference(p[i]...); }, _base);
+        }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        iterator_base &operator++() { return ++_i, *this; }
+        iterator_base operator++(int) { return {_base, _i++}; }
+        iterator_base &operator--() { return --_i, *this; }
+        iterator_base operator--(int) { return {_base, _i--}; }
+        iterator_base &operator+=(difference_type n) { return _i += n, *this; }
+        iterator_base &operator-=(difference_type n) { return _i -= n, *this; }
+
+        friend iterator_base operator+(iterator_base it, difference_type n) { return it += n; }
+        friend iterator_base operator+(difference_type n, iterator_base it) { return it += n; }
+        friend iterator_base operator-(iterator_base it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const iterator_base &a, const iterator_base &b) {
+            return a._i - b._i;
+        }
+        friend bool operator==(const iterator_base &a, const iterator_base &b) {
+            return a._i == b._i;
+        }
+        friend auto operator<=>(const iterator_base &a, const iterator_base &b) {
+            return a._i <=> b._i;
+        }
+
+        friend iterator_base<!Const>;
+    };
+
+    template <typename F> void each_field(F f) {
+        std::apply([&f](auto &...v) { (f(v), ...); }, _fields);
+    }
+
+  public:
+    template <size_t I> using field_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+    using value_type = std::tuple<Ts...>;
+    using reference = std::tuple<Ts &...>;
+    using const_reference = std::tuple<const Ts &...>;
+    using iterator = iterator_base<false>;
+    using const_iterator = iterator_base<true>;
+
+    soa_vector() = default;
+    explicit soa_vector(size_t n) : _fields(std::vector<Ts>(n)...) {}
+
+    // From a range of tuple-likes (tuples, pairs, arrays) with one element per
+    // field, like what prelude::ints<N> gives.
+    template <std::ranges::input_range R>
+        requires(!std::is_same_v<std::remove_cvref_t<R>, soa_vector>)
+    explicit soa_vector(R &&r) {
+        if constexpr (std::ranges::sized_range<R>) {
+            reserve(std::ranges::size(r));
+        }
+        for (auto &&x : r) {
+            std::apply([this](auto &&...v) { emplace_back(std::forward<decltype(v)>(v)...); },
+                       std::forward<decltype(x)>(x));
+        }
+    }
+
+    size_t size() const { return std::get<0>(_fields).size(); }
+    bool empty() const { return size() == 0; }
+
+    void reserve(size_t n) {
+        each_field([n](auto &v) { v.reserve(n); });
+    }
+    void resize(size_t n) {
+        each_field([n](auto &v) { v.resize(n); });
+    }
+    void clear() {
+        each_field([](auto &v) { v.clear(); });
+    }
+
+    template <typename... A>
+        requires(sizeof...(A) == sizeof...(Ts))
+    void emplace_back(A &&...a) {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (std::get<I>(_fields).emplace_back(std::forward<A>(a)), ...);
+        }(std::index_sequence_for<Ts...>{});
+    }
+    void push_back(const value_type &x) {
+        std::apply([this](const auto &...v) { emplace_back(v...); }, x);
+    }
+
+    // Field I as one contiguous span.
+    template <size_t I> std::span<field_type<I>> field() { return std::get<I>(_fields); }
+    template <size_t I> std::span<const field_type<I>> field() const {
+        return std::get<I>(_fields);
+    }
+
+    reference operator[](size_t i) { return begin()[i]; }
+    const_reference operator[](size_t i) const { return begin()[i]; }
+
+    iterator begin() {
+        return {std::apply([](auto &...v) { return std::tuple(v.data()...); }, _fields), 0};
+    }
+    iterator end() { return begin() + size(); }
+    const_iterator begin() const {
+        return {std::apply([](auto &...v) { return std::tuple(v.data()...); }, _fields), 0};
+    }
+    const_iterator end() const { return begin() + size(); }
+};
+
+} // namespace prelude
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "prelude/parallel.hpp"
+#include "prelude/trace.hpp"
+
+// radix_sort(v, key): a stable sort of a contiguous range by an integer key,
+// a byte at a time from the bottom, each pass split across the pool. It
+// looks at every record a fixed number of times instead of log n, and it
+// skips bytes that are the same in every key, so keys that only use their
+// low 40 bits take 5 passes, not 8.
+//
+// Each pass moves whole records, so small records sort fastest. key_packer
+// squeezes a key and a payload (an index, a pair of indices) into a single
+// uint64_t, which sorts on its own with no projection:
+//
+//     prelude::key_packer pack(max_distance, max_index);
+//     std::vector<uint64_t> edges;
+//     ...
+//     edges.push_back(pack(distance, index));
+//     prelude::radix_sort(edges);
+//     ... pack.payload(edges.front()) ...
+
+namespace prelude {
+
+namespace detail {
+// Below this many records one thread does the whole sort.
+inline constexpr size_t radix_parallel_min = size_t{1} << 16;
+
+// Key bits in an order that sorts like the key: signed keys get their sign
+// bit flipped so negatives come first.
+template <std::integral K> constexpr auto radix_bits(K k) {
+    using U = std::make_unsigned_t<K>;
+    U u = static_cast<U>(k);
+    if constexpr (std::is_signed_v<K>) {
+        u ^= U{1} << (8 * sizeof(K) - 1);
+    }
+    return u;
+}
+
+// from[i] to to[next[digit(from[i])]++], in order. Small trivially copyable
+// records are staged a cache line per digit and written out a line at a
+// time, which spares most of the cache and TLB misses of 256 write streams.
+template <typename T, typename Digit>
+void radix_scatter(std::span<T> from, std::span<T> to, std::array<size_t, 256> &next,
+                   Digit digit) {
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= 32) {
+        constexpr size_t line = 64 / sizeof(T);
+        alignas(64) unsigned char staged[256][line * sizeof(T)];
+        std::array<uint8_t, 256> fill{};
+        for (const T &x : from) {
+            const size_t d = digit(x);
+            std::memcpy(staged[d] + fill[d] * sizeof(T), &x, sizeof(T));
+            if (++fill[d] == line) {
+                std::memcpy(to.data() + next[d], staged[d], sizeof(staged[d]));
+                next[d] += line;
+                fill[d] = 0;
+            }
+        }
+        for (size_t d = 0; d < 256; ++d) {
+            std::memcpy(to.data() + next[d], staged[d], fill[d] * sizeof(T));
+        }
+    } else {
+        for (T &x : from) {
+            to[next[digit(x)]++] = std::move(x);
+        }
+    }
+}
+
+template <typename R, typename Key>
+using radix_key_t
+    = std::remove_cvref_t<std::invoke_result_t<Key &, std::ranges::range_reference_t<R>>>;
+} // namespace detail
+
+template <std::ranges::contiguous_range R, typename Key = std::identity>
+    requires std::ranges::sized_range<R> && std::integral<detail::radix_key_t<R, Key>>
+             && (!std::same_as<detail::radix_key_t<R, Key>, bool>)
+void radix_sort(R &&r, Key key = {}, thread_pool &pool = default_pool()) {
+    using T = std::ranges::range_value_t<R>;
+    using counts = std::array<size_t, 256>;
+    constexpr size_t passes = sizeof(detail::radix_key_t<R, Key>);
+
+    const std::span<T> data(std::ranges::data(r), std::ranges::size(r));
+    const size_t n = data.size();
+    if (n < 256) {
+        std::ranges::stable_sort(data, {}, key);
+        return;
+    }
+    auto bits = [&key](const T &x) { return detail::radix_bits(std::invoke(key, x)); };
+
+    const size_t blocks = n < detail::radix_parallel_min ? 1 : pool.size();
+    const size_t block = (n + blocks - 1) / blocks;
+    auto block_range = [&](size_t b) {
+        return std::pair(b * block, std::min(n, (b + 1) * block));
+    };
+
+    // Every pass's digit counts in one read. A pass whose digit is the same
+    // in every key would leave the order alone, so it's skipped.
+    std::vector<std::array<counts, passes>> hist(blocks);
+    pool.parallel_for(blocks, [&](size_t b) {
+        AOC_TRACE_SPAN("radix_sort count", "block", static_cast<long>(b));
+        auto &h = hist[b];
+        for (auto [i, end] = block_range(b); i < end; ++i) {
+            const auto u = bits(data[i]);
+            for (size_t p = 0; p < passes; ++p) {
+                ++h[p][(u >> (8 * p)) & 0xff];
+            }
+        }
+    });
+
+    std::unique_ptr<T[]> buffer;
+    std::span<T> from = data, to;
+    bool scattered = false;
+    for (size_t p = 0; p < passes; ++p) {
+        size_t largest = 0;
+        for (size_t d = 0; d < 256; ++d) {
+            size_t total = 0;
+            for (auto &h : hist) {
+                total += h[p][d];
+            }
+            largest = std::max(largest, total);
+        }
+        if (largest == n) {
+            continue;
+        }
+        if (!buffer) {
+            buffer = std::make_unique_for_overwrite<T[]>(n);
+            to = std::span<T>(buffer.get(), n);
+        }
+
+        // Per-block counts are for the order the blocks were in when they
+        // were counted; after the first scatter that's changed.
+        if (scattered && blocks > 1) {
+            pool.parallel_for(blocks, [&](size_t b) {
+                auto &h = hist[b][p];
+                h.fill(0);
+                for (auto [i, end] = block_range(b); i < end; ++i) {
+                    ++h[(bits(from[i]) >> (8 * p)) & 0xff];
+                }
+            });
+        }
+
+        // Digit-major, block-minor, so each block's records of a digit land
+        // after the earlier blocks' ones: that's what keeps it stable.
+        std::vector<counts> next(blocks);
+        size_t at = 0;
+        for (size_t d = 0; d < 256; ++d) {
+            for (size_t b = 0; b < blocks; ++b) {
+                next[b][d] = at;
+                at += hist[b][p][d];
+            }
+        }
+        pool.parallel_for(blocks, [&](size_t b) {
+            AOC_TRACE_SPAN("radix_sort pass", "pass", static_cast<long>(p));
+            auto [begin, end] = block_range(b);
+            detail::radix_scatter(from.subspan(begin, end - begin), to, next[b],
+                                  [&](const T &x) { return (bits(x) >> (8 * p)) & 0xff; });
+        });
+        std::swap(from, to);
+        scattered = true;
+    }
+
+    if (from.data() != data.data()) {
+        std::ranges::move(from, data.begin());
+    }
+}
+
+// A key and a payload in one uint64_t, key in the high bits, so sorting the
+// words sorts by key and the payload comes along: 8 bytes a record, where a
+// {key, index} struct would be 16. Sized for the largest key and payload
+// it'll see; throws std::out_of_range if the two need more than 64 bits, so
+// check fits() first and fall back to a wider record if they might.
+class key_packer {
+    int _payload_bits;
+
+  public:
+    key_packer(uint64_t max_key, uint64_t max_payload)
+        : _payload_bits(std::bit_width(max_payload)) {
+        if (!fits(max_key, max_payload)) {
+            throw std::out_of_range("key_packer: key and payload need more than 64 bits");
+        }
+    }
+
+    static constexpr bool fits(uint64_t max_key, uint64_t max_payload) {
+        const int payload_bits = std::bit_width(max_payload);
+        return payload_bits + std::bit_width(max_key) <= 64 && payload_bits < 64;
+    }
+
+    uint64_t operator()(uint64_t key, uint64_t payload) const {
+        return key << _payload_bits | payload;
+    }
+    uint64_t key(uint64_t w) const { return w >> _payload_bits; }
+    uint64_t payload(uint64_t w) const { return w & ((uint64_t{1} << _payload_bits) - 1); }
+};
+
+} // namespace prelude
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+#include "prelude/alloc.hpp"
+#include "prelude/perf.hpp"
+
+// Phase timing. Wrap a phase in a scoped_timer and, when timing is switched
+// on, its wall-clock and CPU time are added up under its name and written out
+// as JSON when the process exits:
+//
+//     AOC_TIMING=timings.json bazel run //2025:day8 < input.txt
+//
+// AOC_TIMING=- writes the report to stderr instead, and the day binaries
+// take --timing=PATH as well. prelude::solve already times parse, part1 and
+// part2; a timer started inside one of those is recorded as a sub-phase,
+// e.g. "parse/sort". Timers in pool threads don't know what started them and
+// are recorded at the top level.
+//
+// CPU time is for the whole process, so a phase that keeps the pool busy shows
+// more CPU than wall time. With timing off a scoped_timer costs a branch.
+//
+// In binaries with the allocation tracker linked in (alloc.hpp), every phase
+// also gets its allocation count, bytes allocated and peak live heap bytes.
+// With $AOC_PERF=1 (or --perf) each phase also gets the hardware counters
+// from perf.hpp, for whichever of them the machine lets us open; the report
+// then goes to stderr unless it was asked for somewhere else.
+
+namespace prelude {
+
+namespace detail {
+inline std::chrono::nanoseconds cpu_now() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+inline std::string json_string(std::string_view s) {
+    std::string out = "\"";
+    for (char ch : s) {
+        switch (ch) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                out += fmt::format("\\u{:04x}", ch);
+            } else {
+                out.push_back(ch);
+            }
+        }
+    }
+    out.push_back('"');
+    return out;
+}
+} // namespace detail
+
+class timings {
+  public:
+    struct phase {
+        std::string name;
+        long count = 0;
+        std::chrono::nanoseconds wall{0};
+        std::chrono::nanoseconds cpu{0};
+        alloc_stats allocs{}; // count and bytes summed over runs, peak is the max
+        perf_sample perf{};
+    };
+
+  private:
+    std::mutex _m;
+    std::vector<phase> _phases; // in the order they first ran
+    std::vector<std::pair<std::string, std::string>> _meta; // values are already JSON
+    std::string _path;
+    std::atomic<bool> _enabled{false};
+    std::unique_ptr<perf_counters> _perf; // null unless enabled and something opened
+
+  public:
+    timings() = default;
+    timings(const timings &) = delete;
+    timings &operator=(const timings &) = delete;
+
+    ~timings() {
+        if (enabled()) {
+            write();
+        }
+    }
+
+    // Start recording; the report goes to path when this is destroyed, or to
+    // stderr if path is "-".
+    void enable(std::string path) {
+        std::lock_guard lk(_m);
+        _path = std::move(path);
+        _enabled.store(true, std::memory_order_relaxed);
+    }
+
+    bool enabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    // Read the hardware counters around every phase too. Call it at startup,
+    // before any threads are running: the counters only follow threads
+    // created after this.
+    void enable_perf() {
+        if (_perf) {
+            return;
+        }
+        auto counters = std::make_unique<perf_counters>();
+        if (!counters->error().empty()) {
+            annotate("perf_error", counters->error());
+        }
+        if (counters->any()) {
+            _perf = std::move(counters);
+        }
+    }
+
+    const perf_counters *perf() const { return _perf.get(); }
+
+    // Extra top-level fields for the report.
+    void annotate(std::string key, std::string_view value) {
+        std::lock_guard lk(_m);
+        _meta.emplace_back(std::move(key), detail::json_string(value));
+    }
+
+    void annotate(std::string key, long value) {
+        std::lock_guard lk(_m);
+        _meta.emplace_back(std::move(key), fmt::format("{}", value));
+    }
+
+    void add(std::string_view name, std::chrono::nanoseconds wall, std::chrono::nanoseconds cpu,
+             const alloc_stats &allocs = {}, const perf_sample &perf = {}) {
+        std::lock_guard lk(_m);
+        auto it = std::find_if(_phases.begin(), _phases.end(),
+                               [name](const phase &p) { return p.name == name; });
+        if (it == _phases.end()) {
+            it = _phases.insert(_phases.end(), phase{std::string(name)});
+        }
+        ++it->count;
+        it->wall += wall;
+        it->cpu += cpu;
+        it->allocs.count += allocs.count;
+        it->allocs.bytes += allocs.bytes;
+        it->allocs.peak = std::max(it->allocs.peak, allocs.peak);
+        for (size_t i = 0; i < perf.size(); ++i) {
+            it->perf[i] += perf[i];
+        }
+    }
+
+    std::vector<phase> phases() {
+        std::lock_guard lk(_m);
+        return _phases;
+    }
+
+    std::string json() {
+        std::lock_guard lk(_m);
+        std::string out = "{\n";
+        for (const auto &[key, value] : _meta) {
+            out += fmt::format("  {}: {},\n", detail::json_string(key), value);
+        }
+        out += "  \"phases\": [";
+        for (size_t i = 0; i < _phases.size(); ++i) {
+            const auto &p = _phases[i];
+            out += fmt::format("{}\n    {{\"name\": {}, \"count\": {}, \"wall_ns\": {}, "
+                               "\"cpu_ns\": {}",
+                               i == 0 ? "" : ",", detail::json_string(p.name), p.count,
+                               p.wall.count(), p.cpu.count());
+            if (alloc_tracking()) {
+                out += fmt::format(", \"allocs\": {}, \"alloc_bytes\": {}, \"peak_bytes\": {}",
+                                   p.allocs.count, p.allocs.bytes, p.allocs.peak);
+            }
+            for (size_t i = 0; _perf && i < perf_events.size(); ++i) {
+                if (_perf->available(i)) {
+                    out += fmt::format(", \"{}\": {}", perf_events[i].name, p.perf[i]);
+                }
+            }
+            out += "}";
+        }
+        out += "\n  ]\n}\n";
+        return out;
+    }
+
+    void write() {
+        const std::string report = json();
+        if (_path == "-") {
+            std::fputs(report.c_str(), stderr);
+            return;
+        }
+        std::FILE *f = std::fopen(_path.c_str(), "w");
+        if (!f) {
+            fmt::print(stderr, "can't write timings to {}\n", _path);
+            return;
+        }
+        std::fputs(report.c_str(), f);
+        std::fclose(f);
+    }
+};
+
+// The process-wide timings, switched on by $AOC_TIMING if it's set, with
+// hardware counters if $AOC_PERF is.
+inline timings &timing() {
+    static timings t;
+    static const bool from_env = [] {
+        if (const char *env = std::getenv("AOC_TIMING"); env && *env) {
+            t.enable(env);
+        }
+        if (const char *env = std::getenv("AOC_PERF"); env && *env && *env != '0') {
+            t.enable_perf();
+            if (!t.enabled()) {
+                t.enable("-");
+            }
+        }
+        return true;
+    }();
+    (void)from_env;
+    return t;
+}
+
+// Times from construction to destruction and adds it to `name`, nested under
+// whatever timers are already running on this thread.
+//
+// A task that a pool thread picks up while it waits on something of its own
+// isn't part of that something, so it can ask to start at the top level
+// instead, with scoped_timer(scoped_timer::top_level, name).
+class scoped_timer {
+    static inline thread_local std::string tl_path;
+
+    timings *_t = nullptr;
+    size_t _outer = 0;  // length of tl_path to restore
+    std::string _saved; // or all of it, for a top-level timer
+    bool _top = false;
+    std::chrono::steady_clock::time_point _wall;
+    std::chrono::nanoseconds _cpu{0};
+    std::optional<alloc_scope> _allocs;
+    perf_sample _perf{};
+
+  public:
+    struct top_level_t {};
+    static constexpr top_level_t top_level{};
+
+    explicit scoped_timer(std::string_view name, timings &t = timing()) { start(name, t); }
+
+    scoped_timer(top_level_t, std::string_view name, timings &t = timing()) {
+        if (t.enabled()) {
+            _saved = std::exchange(tl_path, {});
+            _top = true;
+        }
+        start(name, t);
+    }
+
+    scoped_timer(const scoped_timer &) = delete;
+    scoped_timer &operator=(const scoped_timer &) = delete;
+
+    ~scoped_timer() {
+        if (!_t) {
+            return;
+        }
+        const auto wall = std::chrono::steady_clock::now() - _wall;
+        const auto cpu = detail::cpu_now() - _cpu;
+        perf_sample perf{};
+        if (auto counters = _t->perf()) {
+            perf = counters->read();
+            for (size_t i = 0; i < perf.size(); ++i) {
+                perf[i] -= _perf[i];
+            }
+        }
+        _t->add(tl_path, std::chrono::duration_cast<std::chrono::nanoseconds>(wall), cpu,
+                _allocs ? _allocs->stats() : alloc_stats{}, perf);
+        if (_top) {
+            tl_path = std::move(_saved);
+        } else {
+            tl_path.resize(_outer);
+        }
+    }
+
+  private:
+    void start(std::string_view name, timings &t) {
+        if (!t.enabled()) {
+            return;
+        }
+        _t = &t;
+        _outer = tl_path.size();
+        if (!tl_path.empty()) {
+            tl_path.push_back('/');
+        }
+        tl_path.append(name);
+        if (alloc_tracking()) {
+            _allocs.emplace();
+        }
+        if (auto perf = t.perf()) {
+            _perf = perf->read();
+        }
+        _cpu = detail::cpu_now();
+        _wall = std::chrono::steady_clock::now();
+    }
+};
+
+} // namespace prelude
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+// Per-thread begin/end spans written out as a Chrome trace-event file, for
+// seeing what every thread was doing when (load imbalance, idle workers, the
+// one z3 solve that took a second). Open the file in https://ui.perfetto.dev
+// or chrome://tracing.
+//
+// Spans only exist in builds with AOC_TRACE defined (bazel build
+// --define trace=1); otherwise AOC_TRACE_SPAN expands to nothing and its
+// arguments aren't even evaluated. In a tracing build, nothing is recorded
+// until a trace file is named with $AOC_TRACE_FILE or --trace=PATH:
+//
+//     AOC_TRACE_SPAN("calcMachine2");                // this scope
+//     AOC_TRACE_SPAN("chunk", "index", i);           // with an integer argument
+//
+// Span and argument names must be string literals (or otherwise live to the
+// end of the program): only the pointers are kept. Every thread appends to its own buffer,
+// so a span costs two clock reads and a push_back.
+
+namespace prelude {
+
+struct trace_event {
+    const char *name;
+    const char *arg_name; // null if there's no argument
+    long arg;
+    std::chrono::nanoseconds begin;
+    std::chrono::nanoseconds duration;
+};
+
+class tracer {
+    struct buffer {
+        int tid;
+        std::vector<trace_event> events;
+    };
+
+    std::mutex _m;
+    std::vector<std::shared_ptr<buffer>> _buffers; // outlive their threads
+    std::string _path;
+    std::atomic<bool> _enabled{false};
+    const std::chrono::steady_clock::time_point _epoch = std::chrono::steady_clock::now();
+
+    buffer &local() {
+        // one buffer per thread per tracer; in practice there's only trace()
+        thread_local const tracer *owner = nullptr;
+        thread_local std::shared_ptr<buffer> buf;
+        if (owner != this) {
+            std::lock_guard lk(_m);
+            buf = std::make_shared<buffer>();
+            buf->tid = static_cast<int>(_buffers.size());
+            buf->events.reserve(1024);
+            _buffers.push_back(buf);
+            owner = this;
+        }
+        return *buf;
+    }
+
+  public:
+    tracer() = default;
+    tracer(const tracer &) = delete;
+    tracer &operator=(const tracer &) = delete;
+
+    // Written when the process exits, by which point the pool has joined its
+    // workers: default_pool() makes trace() before the pool, so it's
+    // destroyed after, even when the first span is on a worker.
+    ~tracer() {
+        if (enabled()) {
+            write();
+        }
+    }
+
+    void enable(std::string path) {
+        std::lock_guard lk(_m);
+        _path = std::move(path);
+        _enabled.store(true, std::memory_order_relaxed);
+    }
+
+    bool enabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    std::chrono::nanoseconds now() const { return std::chrono::steady_clock::now() - _epoch; }
+
+    void record(const trace_event &e) { local().events.push_back(e); }
+
+    std::string json() {
+        std::lock_guard lk(_m);
+        std::string out = "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+        bool first = true;
+        auto sep = [&] {
+            out += first ? "  " : ",\n  ";
+            first = false;
+        };
+        for (const auto &b : _buffers) {
+            sep();
+            out += fmt::format("{{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+                               "\"tid\": {}, \"args\": {{\"name\": \"thread {}\"}}}}",
+                               b->tid, b->tid);
+            for (const auto &e : b->events) {
+                sep();
+                // trace-event times are microseconds; keep the nanoseconds
+                out += fmt::format("{{\"name\": \"{}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, "
+                                   "\"ts\": {:.3f}, \"dur\": {:.3f}",
+                                   e.name, b->tid, e.begin.count() / 1e3,
+                                   e.duration.count() / 1e3);
+                if (e.arg_name) {
+                    out += fmt::format(", \"args\": {{\"{}\": {}}}", e.arg_name, e.arg);
+                }
+                out += "}";
+            }
+        }
+        out += "\n]}\n";
+        return out;
+    }
+
+    void write() {
+        const std::string trace = json();
+        std::FILE *f = std::fopen(_path.c_str(), "w");
+        if (!f) {
+            fmt::print(stderr, "can't write trace to {}\n", _path);
+            return;
+        }
+        std::fputs(trace.c_str(), f);
+        std::fclose(f);
+    }
+};
+
+// The process-wide tracer, switched on by $AOC_TRACE_FILE if it's set.
+inline tracer &trace() {
+    static tracer t;
+    static const bool from_env = [] {
+        if (const char *env = std::getenv("AOC_TRACE_FILE"); env && *env) {
+            t.enable(env);
+        }
+        return true;
+    }();
+    (void)from_env;
+    return t;
+}
+
+// Records one span from construction to destruction. Use AOC_TRACE_SPAN
+// rather than this directly, so it compiles away when tracing is off.
+class trace_span {
+    tracer *_t = nullptr;
+    trace_event _e{};
+
+  public:
+    explicit trace_span(const char *name, tracer &t = trace())
+        : trace_span(name, nullptr, 0, t) {}
+
+    trace_span(const char *name, const char *arg_name, long arg, tracer &t = trace()) {
+        if (t.enabled()) {
+            _t = &t;
+            _e = trace_event{name, arg_name, arg, t.now(), {}};
+        }
+    }
+
+    trace_span(const trace_span &) = delete;
+    trace_span &operator=(const trace_span &) = delete;
+
+    ~trace_span() {
+        if (_t) {
+            _e.duration = _t->now() - _e.begin;
+            _t->record(_e);
+        }
+    }
+};
+
+} // namespace prelude
+
+#define AOC_TRACE_CONCAT_(a, b) a##b
+#define AOC_TRACE_CONCAT(a, b) AOC_TRACE_CONCAT_(a, b)
+
+#ifdef AOC_TRACE
+#define AOC_TRACE_SPAN(...)                                                                        \
+    const ::prelude::trace_span AOC_TRACE_CONCAT(aoc_trace_span_, __LINE__)(__VA_ARGS__)
+#else
+#define AOC_TRACE_SPAN(...) static_cast<void>(0)
+#endif